@@ -0,0 +1,161 @@
+#include "GAreaRasterizer.h"
+#include "include/GMath.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+
+GAreaRasterizer::GAreaRasterizer(GIRect clip)
+    : fClip(clip), fStride(std::max(0, clip.width()) + 2),
+      fAccum(static_cast<size_t>(fStride) * std::max(0, clip.height()), 0),
+      fMinX(std::max(0, clip.height()), fStride), fMaxX(std::max(0, clip.height()), -1) {}
+
+void GAreaRasterizer::addPath(const GPath& path) {
+    flatten_path(path, [this](GPoint p0, GPoint p1) { addLine(p0, p1); });
+}
+
+void GAreaRasterizer::addLine(GPoint p0, GPoint p1) {
+    p0 = {p0.x - fClip.left, p0.y - fClip.top};
+    p1 = {p1.x - fClip.left, p1.y - fClip.top};
+    if (p0.y == p1.y || fAccum.empty()) {
+        return;
+    }
+
+    //* split where the line crosses x = 0 and x = width; the pieces outside are projected
+    //* onto that boundary, where they still contribute their cover to the pixels inside
+    float w = fClip.width();
+    float ts[4] = {0, 1, 1, 1};
+    int n = 1;
+    if (p0.x != p1.x) {
+        for (auto edge : {0.0f, w}) {
+            auto t = (edge - p0.x) / (p1.x - p0.x);
+            if (t > 0 && t < 1) {
+                ts[n++] = t;
+            }
+        }
+    }
+    std::sort(ts + 1, ts + n);
+    ts[n] = 1;
+
+    auto clampX = [&](GPoint p) { return GPoint{std::max(0.0f, std::min(w, p.x)), p.y}; };
+    for (auto i = 0; i < n; i++) {
+        auto a = i == 0 ? p0 : p0 + ts[i] * (p1 - p0);
+        auto b = i == n - 1 ? p1 : p0 + ts[i + 1] * (p1 - p0);
+        accumulate_line(fAccum.data(), fStride, {fClip.width(), fClip.height()}, clampX(a),
+                        clampX(b), fMinX.data(), fMaxX.data());
+    }
+}
+
+void accumulate_line(float acc[], int stride, GISize size, GPoint p0, GPoint p1, int minX[],
+                     int maxX[]) {
+    float dir = 1;
+    if (p0.y > p1.y) {
+        std::swap(p0, p1);
+        dir = -1;
+    }
+    if (p0.y == p1.y) {
+        return;
+    }
+    float w = size.width;
+    float h = size.height;
+    auto dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    auto x = p0.x;
+    auto y0 = p0.y;
+    auto y1 = std::min(p1.y, h);
+    if (y0 < 0) {
+        x -= y0 * dxdy;
+        y0 = 0;
+    }
+
+    for (auto y = GFloorToInt(y0); y < y1; y++) {
+        auto row = &acc[static_cast<size_t>(y) * stride];
+        auto dy = std::min(y + 1.0f, y1) - std::max(static_cast<float>(y), y0);
+        auto xnext = std::max(0.0f, std::min(w, x + dxdy * dy));
+        auto d = dy * dir;
+        auto x0 = std::min(x, xnext);
+        auto x1 = std::max(x, xnext);
+        auto x0floor = std::floor(x0);
+        auto x0i = static_cast<int>(x0floor);
+        auto x1i = GCeilToInt(x1);
+        if (x1i <= x0i + 1) {
+            // the line stays within one pixel column on this row
+            auto xmf = 0.5f * (x + xnext) - x0floor;
+            row[x0i] += d - d * xmf;
+            row[x0i + 1] += d * xmf;
+            x1i = x0i + 1;
+        } else {
+            auto s = 1 / (x1 - x0);
+            auto x0f = x0 - x0floor;
+            auto a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+            auto x1f = x1 - x1i + 1;
+            auto am = 0.5f * s * x1f * x1f;
+            row[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                row[x0i + 1] += d * (1 - a0 - am);
+            } else {
+                auto a1 = s * (1.5f - x0f);
+                row[x0i + 1] += d * (a1 - a0);
+                for (auto xi = x0i + 2; xi < x1i - 1; xi++) {
+                    row[xi] += d * s;
+                }
+                auto a2 = a1 + (x1i - x0i - 3) * s;
+                row[x1i - 1] += d * (1 - a2 - am);
+            }
+            row[x1i] += d * am;
+        }
+        if (minX) {
+            minX[y] = std::min(minX[y], x0i);
+            maxX[y] = std::max(maxX[y], x1i);
+        }
+        x = xnext;
+    }
+}
+
+float resolve_coverage_row(float acc[], uint8_t coverage[], int n, float sum) {
+    int i = 0;
+#ifdef __SSE2__
+    //* in-register prefix sum of 4 floats: x += x << 1 lane, x += x << 2 lanes
+    auto offset = _mm_set1_ps(sum);
+    const auto signMask = _mm_set1_ps(-0.0f);
+    const auto one = _mm_set1_ps(1.0f);
+    const auto scale = _mm_set1_ps(255.0f);
+    const auto half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= n; i += 4) {
+        auto x = _mm_loadu_ps(acc + i);
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+        x = _mm_add_ps(x, offset);
+        offset = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_ps(acc + i, _mm_setzero_ps());
+
+        auto c = _mm_min_ps(_mm_andnot_ps(signMask, x), one);
+        auto c32 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(c, scale), half));
+        auto c8 = _mm_packus_epi16(_mm_packs_epi32(c32, c32), c32);
+        auto packed = _mm_cvtsi128_si32(c8);
+        memcpy(coverage + i, &packed, 4);
+    }
+    sum = _mm_cvtss_f32(offset);
+#endif
+    for (; i < n; i++) {
+        sum += acc[i];
+        acc[i] = 0;
+        coverage[i] = static_cast<uint8_t>(std::min(1.0f, std::abs(sum)) * 255 + 0.5f);
+    }
+    return sum;
+}
+
+void GAreaRasterizer::blit(const GPaint& paint, const GBitmap& device) {
+    std::vector<uint8_t> coverage(fStride);
+    for (auto y = 0; y < fClip.height(); y++) {
+        auto minX = fMinX[y];
+        if (minX > fMaxX[y]) {
+            continue;
+        }
+        // the deposits of closed contours sum to zero, so coverage is 0 past maxX
+        auto count = std::min(fMaxX[y], fClip.width()) - minX;
+        resolve_coverage_row(&fAccum[static_cast<size_t>(y) * fStride + minX], coverage.data(),
+                             fMaxX[y] + 1 - minX, 0);
+        blend_anti_row(fClip.left + minX, fClip.top + y, count, coverage.data(), paint, device);
+        fMinX[y] = fStride;
+        fMaxX[y] = -1;
+    }
+}
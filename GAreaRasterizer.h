@@ -0,0 +1,109 @@
+#ifndef GAreaRasterizer_DEFINED
+#define GAreaRasterizer_DEFINED
+
+#include "include/GBitmap.h"
+#include "include/GMath.h"
+#include "include/GPaint.h"
+#include "include/GPath.h"
+#include "include/GPoint.h"
+#include "include/GRect.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ *  Anti-aliased rasterizer that computes exact per-pixel area coverage.
+ *
+ *  Each line segment deposits its signed area (for the pixels it passes through) and cover (for
+ *  everything to its right) into an accumulation buffer. A prefix sum over each row then turns
+ *  the deposits into the winding-weighted coverage of every pixel, clamped to 1 (non-zero rule).
+ *  There is no active edge list and no sorting, so the cost is the number of edges plus one pass
+ *  over the path's bounds.
+ */
+class GAreaRasterizer {
+public:
+    // clip is the device-space area that will be blitted, e.g. the path's bounds on the device.
+    explicit GAreaRasterizer(GIRect clip);
+
+    // Add the edges of the (device space) path, flattening curves into lines.
+    void addPath(const GPath&);
+
+    void addLine(GPoint p0, GPoint p1);
+
+    // Resolve the accumulated coverage and blend the paint into the device with it.
+    void blit(const GPaint&, const GBitmap& device);
+
+private:
+    GIRect fClip;
+    int fStride;
+    std::vector<float> fAccum;
+    // per row, the range of columns that received deposits
+    std::vector<int> fMinX, fMaxX;
+};
+
+/**
+ *  Deposit the signed area and cover of the line into acc (size.height rows of stride floats).
+ *  The line is relative to acc with x already within [0, size.width], and stride must be at
+ *  least size.width + 2. Only the part of the line within [0, size.height] is deposited. If
+ *  minX/maxX are not null, they are widened per row to the columns that were written.
+ */
+void accumulate_line(float acc[], int stride, GISize size, GPoint p0, GPoint p1, int minX[],
+                     int maxX[]);
+
+/**
+ *  Prefix-sum acc[0..n), starting from sum, into coverage (|winding| clamped to 1, as 0..255)
+ *  and zero acc. Returns the final sum, i.e. the winding carried into whatever is to the right.
+ */
+float resolve_coverage_row(float acc[], uint8_t coverage[], int n, float sum);
+
+// Walk the path's edges, calling line(p0, p1) for each line segment after flattening curves.
+template <typename Line> void flatten_path(const GPath& path, Line&& line) {
+    GPath::Edger edger(path);
+    GPoint pts[GPath::kMaxNextPoints];
+    while (auto v = edger.next(pts)) {
+        switch (v.value()) {
+        case GPathVerb::kLine:
+            line(pts[0], pts[1]);
+            break;
+        case GPathVerb::kQuad: {
+            // P(t) = A + 2t(B - A) + t^2(A - 2B + C)
+            auto A = pts[0];
+            auto b = 2 * (pts[1] - A);
+            auto a = A - 2 * pts[1] + pts[2];
+            int numSegs = std::max(1, GCeilToInt(std::sqrt(a.length())));
+            auto prev = A;
+            for (auto i = 1; i <= numSegs; i++) {
+                auto t = static_cast<float>(i) / numSegs;
+                auto next = i == numSegs ? pts[2] : A + t * (b + t * a);
+                line(prev, next);
+                prev = next;
+            }
+            break;
+        }
+        case GPathVerb::kCubic: {
+            // P(t) = A + t(c + t(b + t a))
+            auto A = pts[0];
+            auto a = pts[3] - A + 3 * (pts[1] - pts[2]);
+            auto b = 3 * (A - 2 * pts[1] + pts[2]);
+            auto c = 3 * (pts[1] - A);
+            auto E0 = A - 2 * pts[1] + pts[2];
+            auto E1 = pts[1] - 2 * pts[2] + pts[3];
+            GPoint E = {std::max(std::abs(E0.x), std::abs(E1.x)),
+                        std::max(std::abs(E0.y), std::abs(E1.y))};
+            int numSegs = std::max(1, GCeilToInt(std::sqrt(3 * E.length())));
+            auto prev = A;
+            for (auto i = 1; i <= numSegs; i++) {
+                auto t = static_cast<float>(i) / numSegs;
+                auto next = i == numSegs ? pts[3] : A + t * (c + t * (b + t * a));
+                line(prev, next);
+                prev = next;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+#endif
@@ -25,6 +25,11 @@ struct GEdge {
     float getY(float x) { return (x - b) / m; }
 };
 
+// true if the edge from p1 to p2 would be horizontal(), so not worth creating
+inline bool isHorizontalEdge(GPoint p1, GPoint p2) {
+    return GRoundToInt(p1.y) == GRoundToInt(p2.y);
+}
+
 inline GEdge createEdge(GPoint p1, GPoint p2) {
     GPoint top, bottom;
     int winding;
@@ -44,11 +49,11 @@ inline GEdge createEdge(GPoint p1, GPoint p2) {
     return edge;
 }
 
-inline void clipEdgeTo(std::vector<GEdge>& edges, const GBitmap bitmap, GEdge edge) {
+inline void clipEdgeTo(std::vector<GEdge>& edges, GISize clip, GEdge edge) {
     auto minX = 0;
-    auto maxX = bitmap.width() - 1;
+    auto maxX = clip.width - 1;
     auto minY = 0;
-    auto maxY = bitmap.height() - 1;
+    auto maxY = clip.height - 1;
     if (GRoundToInt(edge.top.y) < minY && GRoundToInt(edge.bottom.y) < minY) {
         return;
     }
@@ -58,61 +63,61 @@ inline void clipEdgeTo(std::vector<GEdge>& edges, const GBitmap bitmap, GEdge ed
     if (GRoundToInt(edge.top.y) < minY) {
         edge.top.x = edge.top.x + (edge.m * (minY - edge.top.y));
         edge.top.y = minY;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.bottom.y) > maxY) {
         edge.bottom.x = edge.bottom.x + (edge.m * (maxY - edge.bottom.y));
         edge.bottom.y = maxY;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.top.x) < minX && GRoundToInt(edge.bottom.x) < minX) {
         edge.top.x = minX;
         edge.bottom.x = minX;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.top.x) > maxX && GRoundToInt(edge.bottom.x) > maxX) {
         edge.top.x = maxX;
         edge.bottom.x = maxX;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.top.x) < minX) {
         auto newEdge = createEdge({static_cast<float>(minX), edge.top.y},
                                   {static_cast<float>(minX), (minX - edge.b) / edge.m});
-        clipEdgeTo(edges, bitmap, newEdge);
+        clipEdgeTo(edges, clip, newEdge);
         edge.top.x = minX;
         edge.top.y = (minX - edge.b) / edge.m;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.bottom.x) < minX) {
         auto newEdge = createEdge({static_cast<float>(minX), edge.bottom.y},
                                   {static_cast<float>(minX), (minX - edge.b) / edge.m});
-        clipEdgeTo(edges, bitmap, newEdge);
+        clipEdgeTo(edges, clip, newEdge);
         edge.bottom.x = minX;
         edge.bottom.y = (minX - edge.b) / edge.m;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.top.x) > maxX) {
         auto newEdge = createEdge({static_cast<float>(maxX), edge.top.y},
                                   {static_cast<float>(maxX), (maxX - edge.b) / edge.m});
-        clipEdgeTo(edges, bitmap, newEdge);
+        clipEdgeTo(edges, clip, newEdge);
         edge.top.x = maxX;
         edge.top.y = (maxX - edge.b) / edge.m;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     if (GRoundToInt(edge.bottom.x) > maxX) {
         auto newEdge = createEdge({static_cast<float>(maxX), edge.bottom.y},
                                   {static_cast<float>(maxX), (maxX - edge.b) / edge.m});
-        clipEdgeTo(edges, bitmap, newEdge);
+        clipEdgeTo(edges, clip, newEdge);
         edge.bottom.x = maxX;
         edge.bottom.y = (maxX - edge.b) / edge.m;
-        clipEdgeTo(edges, bitmap, edge);
+        clipEdgeTo(edges, clip, edge);
         return;
     }
     edge.update();
@@ -120,3 +125,7 @@ inline void clipEdgeTo(std::vector<GEdge>& edges, const GBitmap bitmap, GEdge ed
         edges.push_back(edge);
     }
 }
+
+inline void clipEdgeTo(std::vector<GEdge>& edges, const GBitmap bitmap, GEdge edge) {
+    clipEdgeTo(edges, GISize{bitmap.width(), bitmap.height()}, edge);
+}
@@ -1,5 +1,7 @@
 #include "include/GPath.h"
 #include "GEdge.h"
+#include "GStroker.h"
+#include "include/GMath.h"
 #include "include/GMatrix.h"
 #include "include/GPathBuilder.h"
 #include "include/GPoint.h"
@@ -45,7 +47,7 @@ GPoint getCubicPoint(const GPoint src[4], float t) {
 }
 
 GRect GPath::bounds() const {
-    if (fPts.empty()) {
+    if (this->countPoints() == 0) {
         return GRect::WH(0, 0);
     }
 
@@ -73,8 +75,11 @@ GRect GPath::bounds() const {
             auto tx = (A.x - B.x) / (A.x - 2 * B.x + C.x); // t when dx = 0
             auto ty = (A.y - B.y) / (A.y - 2 * B.y + C.y); // t when dy = 0
 
-            update_bounds(bounds, getQuadPoint(pts, tx));
-            update_bounds(bounds, getQuadPoint(pts, ty));
+            for (auto t : {tx, ty}) {
+                if (t > 0 && t < 1) {
+                    update_bounds(bounds, getQuadPoint(pts, t));
+                }
+            }
             break;
         }
         case kCubic: {
@@ -93,8 +98,14 @@ GRect GPath::bounds() const {
             auto tx1 = qx / ax;
             auto tx2 = cx / qx;
 
-            update_bounds(bounds, getCubicPoint(pts, tx1));
-            update_bounds(bounds, getCubicPoint(pts, tx2));
+            // an extremum off the curve, at t outside (0, 1), is not on its bounds; it can be far
+            // out (or not finite) when ax is (nearly) 0, as on a cubic of a circle turned by 45
+            // degrees
+            for (auto t : {tx1, tx2}) {
+                if (t > 0 && t < 1) {
+                    update_bounds(bounds, getCubicPoint(pts, t));
+                }
+            }
 
             auto ay = -3 * A.y + 9 * B.y - 9 * C.y + 3 * D.y;
             auto by = 6 * A.y - 12 * B.y + 6 * C.y;
@@ -104,8 +115,11 @@ GRect GPath::bounds() const {
             auto ty1 = qy / ay;
             auto ty2 = cy / qy;
 
-            update_bounds(bounds, getCubicPoint(pts, ty1));
-            update_bounds(bounds, getCubicPoint(pts, ty2));
+            for (auto t : {ty1, ty2}) {
+                if (t > 0 && t < 1) {
+                    update_bounds(bounds, getCubicPoint(pts, t));
+                }
+            }
 
             break;
         }
@@ -171,6 +185,7 @@ void GPathBuilder::addPolygon(const GPoint pts[], int count) {
 }
 
 void GPathBuilder::addCircle(GPoint center, float radius, GPathDirection direction) {
+    auto isOval = fVbs.empty();
     float k = 0.551915;
     auto mx = GMatrix::Translate(center.x, center.y) * GMatrix::Scale(radius, radius);
     if (direction == GPathDirection::kCW) {
@@ -209,4 +224,311 @@ void GPathBuilder::addCircle(GPoint center, float radius, GPathDirection directi
     }
     // mx.mapPoints(fPts.data(), fPts.data(), fPts.size());
     // transform(mx);
+    if (isOval) {
+        auto r = std::abs(radius);
+        fOvalVerbs = fVbs.size();
+        fOval = GRect::LTRB(center.x - r, center.y - r, center.x + r, center.y + r);
+    }
+}
+
+void GPathBuilder::addStroke(const GPath& path, const GStroke& stroke, float tolerance) {
+    GStroker stroker(stroke, tolerance);
+    stroker.addPath(path);
+    stroker.forEachPiece([this](const GPoint pts[], int count) { addPolygon(pts, count); });
+}
+
+// squared distance from p to the segment a..b
+static float segment_distance2(GPoint p, GPoint a, GPoint b) {
+    auto ab = b - a;
+    auto ap = p - a;
+    auto len2 = ab.x * ab.x + ab.y * ab.y;
+    auto t = len2 > 0 ? std::max(0.0f, std::min(1.0f, (ap.x * ab.x + ap.y * ab.y) / len2)) : 0;
+    auto d = ap - t * ab;
+    return d.x * d.x + d.y * d.y;
+}
+
+/**
+ *  Douglas-Peucker: append to the builder the points of the closed polygon that keep it within
+ *  tolerance of the original, starting a contour with its first point. Drops the polygon if
+ *  fewer than 3 points are needed (so it had no area to speak of).
+ */
+static void add_simplified_contour(GPathBuilder* bu, std::vector<GPoint>& pts, float tolerance,
+                                   std::vector<bool>& keep,
+                                   std::vector<std::pair<int, int>>& stack) {
+    // close the polygon, so the closing edge gets simplified too
+    pts.push_back(pts[0]);
+    auto n = static_cast<int>(pts.size());
+    keep.assign(n, false);
+    keep[0] = keep[n - 1] = true;
+    stack.assign(1, {0, n - 1});
+    while (!stack.empty()) {
+        auto span = stack.back();
+        stack.pop_back();
+        //* keep the point farthest from the span's chord, if it is too far, and split there
+        auto farthest = -1;
+        auto maxDist = tolerance * tolerance;
+        for (auto i = span.first + 1; i < span.second; i++) {
+            auto d = segment_distance2(pts[i], pts[span.first], pts[span.second]);
+            if (d > maxDist) {
+                maxDist = d;
+                farthest = i;
+            }
+        }
+        if (farthest >= 0) {
+            keep[farthest] = true;
+            stack.push_back({span.first, farthest});
+            stack.push_back({farthest, span.second});
+        }
+    }
+    auto count = std::count(keep.begin(), keep.end() - 1, true);
+    if (count < 3) {
+        return;
+    }
+    bu->moveTo(pts[0]);
+    for (auto i = 1; i < n - 1; i++) {
+        if (keep[i]) {
+            bu->lineTo(pts[i]);
+        }
+    }
+}
+
+// lines to flatten a curve into, for an error bound of num / n^2 (at most kMaxFlattenSegments)
+static int flatten_segments(float num) {
+    constexpr float kMaxFlattenSegments = 4096;
+    return std::max(1, GCeilToInt(std::min(kMaxFlattenSegments, std::sqrt(num))));
+}
+
+// the path's contours as polygons within tolerance of it, with their curves flattened
+static std::shared_ptr<GPath> simplify(const GPath& path, float tolerance) {
+    //* half the tolerance for flattening the curves, half for dropping points
+    auto half = tolerance * 0.5f;
+    GPathBuilder bu;
+    std::vector<GPoint> contour;
+    std::vector<bool> keep;
+    std::vector<std::pair<int, int>> stack;
+    auto finishContour = [&]() {
+        if (contour.size() >= 3) {
+            add_simplified_contour(&bu, contour, half, keep, stack);
+        }
+        contour.clear();
+    };
+    auto lineTo = [&](GPoint p) {
+        if (contour.empty() || p != contour.back()) {
+            contour.push_back(p);
+        }
+    };
+
+    GPath::Iter iter(path);
+    GPoint pts[GPath::kMaxNextPoints];
+    while (auto v = iter.next(pts)) {
+        switch (v.value()) {
+        case GPathVerb::kMove:
+            finishContour();
+            contour.push_back(pts[0]);
+            break;
+        case GPathVerb::kLine:
+            lineTo(pts[1]);
+            break;
+        case GPathVerb::kQuad: {
+            // P(t) = A + t(b + t a), and a chord of 1/n of it is within |a| / (4 n^2)
+            auto A = pts[0];
+            auto b = 2 * (pts[1] - A);
+            auto a = A - 2 * pts[1] + pts[2];
+            auto n = flatten_segments(a.length() / (4 * half));
+            for (auto i = 1; i < n; i++) {
+                auto t = static_cast<float>(i) / n;
+                lineTo(A + t * (b + t * a));
+            }
+            lineTo(pts[2]);
+            break;
+        }
+        case GPathVerb::kCubic: {
+            // P(t) = A + t(c + t(b + t a)), and a chord of 1/n of it is within 3|E| / (4 n^2)
+            auto A = pts[0];
+            auto a = pts[3] - A + 3 * (pts[1] - pts[2]);
+            auto b = 3 * (A - 2 * pts[1] + pts[2]);
+            auto c = 3 * (pts[1] - A);
+            auto E0 = A - 2 * pts[1] + pts[2];
+            auto E1 = pts[1] - 2 * pts[2] + pts[3];
+            GVector E = {std::max(std::abs(E0.x), std::abs(E1.x)),
+                         std::max(std::abs(E0.y), std::abs(E1.y))};
+            auto n = flatten_segments(3 * E.length() / (4 * half));
+            for (auto i = 1; i < n; i++) {
+                auto t = static_cast<float>(i) / n;
+                lineTo(A + t * (c + t * (b + t * a)));
+            }
+            lineTo(pts[3]);
+            break;
+        }
+        }
+    }
+    finishContour();
+    return bu.detach();
+}
+
+// a level is only built for points at most this many times its tolerance apart (on average)
+constexpr float kLODMaxSpacing = 16;
+
+const GPath& GPath::levelOfDetail(float tolerance) const {
+    if (tolerance < kLODTolerances[0]) {
+        return *this;
+    }
+    //* all the levels are built together, once, even if several threads draw this path at once
+    auto lods = std::atomic_load(&fLODs);
+    if (!lods) {
+        auto fresh = std::make_shared<LevelsOfDetail>();
+        // if another thread got there first, lods is set to its levels instead
+        if (std::atomic_compare_exchange_strong(&fLODs, &lods, fresh)) {
+            lods = fresh;
+        }
+    }
+    std::call_once(lods->once, [this, &lods]() {
+        // sparse points would not simplify enough to pay for it, and the bounds' perimeter over
+        // the points is a quick estimate of their spacing
+        auto bounds = this->bounds();
+        auto spacing = 2 * (bounds.width() + bounds.height()) / this->countPoints();
+        for (auto level = 0; level < kLODLevels; level++) {
+            if (spacing <= kLODMaxSpacing * kLODTolerances[level]) {
+                auto lod = simplify(*this, kLODTolerances[level]);
+                // a level has to at least halve the points to be worth drawing instead
+                if (2 * lod->countPoints() <= this->countPoints()) {
+                    lods->levels[level] = lod;
+                }
+            }
+        }
+    });
+    for (auto level = kLODLevels - 1; level >= 0; level--) {
+        if (kLODTolerances[level] <= tolerance && lods->levels[level]) {
+            return *lods->levels[level];
+        }
+    }
+    return *this;
+}
+
+// true if b is on the segment a..c (exactly, as the products of floats are exact in double)
+static bool is_between(GPoint a, GPoint b, GPoint c) {
+    double abx = double(b.x) - a.x, aby = double(b.y) - a.y;
+    double acx = double(c.x) - a.x, acy = double(c.y) - a.y;
+    if (abx * acy - aby * acx != 0) {
+        return false;
+    }
+    double cbx = double(b.x) - c.x, cby = double(b.y) - c.y;
+    return abx * acx + aby * acy >= 0 && cbx * acx + cby * acy <= 0;
+}
+
+std::shared_ptr<GPath> GPath::simplified() const {
+    // a contour ending with a curve is left open by Edger if another follows it, and then what
+    // the path covers depends on every edge, so such a path is left as it is
+    for (size_t i = 1; i < fData.vbCount; ++i) {
+        if (fData.vbs[i] == kMove && (fData.vbs[i - 1] == kQuad || fData.vbs[i - 1] == kCubic)) {
+            return this->self();
+        }
+    }
+
+    GPathBuilder bu;
+    bool changed = false;
+    // the current contour: its points (starting with the move's) and the verbs after the move
+    std::vector<GPoint> pts;
+    std::vector<GPathVerb> vbs;
+    bool hasCurves = false;
+
+    auto lineTo = [&](GPoint p) {
+        if (p == pts.back()) {
+            changed = true;
+            return;
+        }
+        //* a line continuing the previous one in the same direction replaces it
+        if (!vbs.empty() && vbs.back() == kLine && is_between(pts[pts.size() - 2], pts.back(), p)) {
+            pts.back() = p;
+            changed = true;
+            return;
+        }
+        pts.push_back(p);
+        vbs.push_back(kLine);
+    };
+    auto finishContour = [&](bool last) {
+        //* Edger closes a contour before the next one only if it ends with a line, so one whose
+        //* last line was dropped after a curve closes with a line of its own
+        if (!last && !vbs.empty() && vbs.back() != kLine && pts.back() != pts[0]) {
+            pts.push_back(pts[0]);
+            vbs.push_back(kLine);
+        }
+        // without a curve, fewer than 3 points enclose nothing
+        if (hasCurves || pts.size() >= 3) {
+            bu.moveTo(pts[0]);
+            auto p = pts.data() + 1;
+            for (auto v : vbs) {
+                switch (v) {
+                    case kLine:
+                        bu.lineTo(p[0]);
+                        p += 1;
+                        break;
+                    case kQuad:
+                        bu.quadTo(p[0], p[1]);
+                        p += 2;
+                        break;
+                    case kCubic:
+                        bu.cubicTo(p[0], p[1], p[2]);
+                        p += 3;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        } else {
+            changed = true;
+        }
+        pts.clear();
+        vbs.clear();
+        hasCurves = false;
+    };
+
+    GPath::Iter iter(*this);
+    GPoint p[kMaxNextPoints];
+    while (auto v = iter.next(p)) {
+        switch (v.value()) {
+            case kMove:
+                if (!pts.empty()) {
+                    finishContour(false);
+                }
+                pts.push_back(p[0]);
+                break;
+            case kLine:
+                lineTo(p[1]);
+                break;
+            case kQuad:
+                //* a quad whose control point is on its chord traces just the chord
+                if (p[0] != p[2] && is_between(p[0], p[1], p[2])) {
+                    lineTo(p[2]);
+                    changed = true;
+                } else if (p[0] == p[1] && p[1] == p[2]) {
+                    changed = true;
+                } else {
+                    pts.insert(pts.end(), p + 1, p + 3);
+                    vbs.push_back(kQuad);
+                    hasCurves = true;
+                }
+                break;
+            case kCubic:
+                // likewise a cubic, if its control points are also in order along the chord
+                if (p[0] != p[3] && is_between(p[0], p[1], p[3]) && is_between(p[1], p[2], p[3])) {
+                    lineTo(p[3]);
+                    changed = true;
+                } else if (p[0] == p[1] && p[1] == p[2] && p[2] == p[3]) {
+                    changed = true;
+                } else {
+                    pts.insert(pts.end(), p + 1, p + 4);
+                    vbs.push_back(kCubic);
+                    hasCurves = true;
+                }
+                break;
+        }
+    }
+    if (!pts.empty()) {
+        finishContour(true);
+    }
+    if (!changed) {
+        return this->self();
+    }
+    return bu.detach();
 }
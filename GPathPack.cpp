@@ -0,0 +1,300 @@
+#include "GPathPack.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// reads back as "GPTH" only in the byte order it was written in
+static constexpr uint32_t kMagic = 0x48545047;
+static constexpr uint32_t kVersion = 1;
+
+enum {
+    kAntiAlias_Flag = 1 << 0,
+    kOval_Flag      = 1 << 1,
+};
+
+struct GPathPack::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;  // of records, which follow the header
+    uint32_t reserved;
+};
+
+// 64 bytes, so the table stays 8-byte aligned after the 16 byte header
+struct GPathPack::Record {
+    uint64_t ptsOffset;  // from the start of the file
+    uint64_t vbsOffset;
+    uint32_t ptCount;
+    uint32_t vbCount;
+    float    color[4];   // r, g, b, a
+    float    oval[4];    // left, top, right, bottom, if kOval_Flag (path() recomputes it)
+    uint8_t  blendMode;
+    uint8_t  flags;
+    uint8_t  reserved[6];
+};
+
+struct GPathPack::Mapping {
+    const char* data = nullptr;
+    size_t      size = 0;
+    bool        mapped = false;  // else data was read into memory from new[]
+
+    ~Mapping() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped) {
+            munmap(const_cast<char*>(data), size);
+            return;
+        }
+#endif
+        delete[] data;
+    }
+};
+
+// fwrite, but an empty array (whose data may be null) is always written
+static bool write_array(FILE* f, const void* data, size_t size, size_t count) {
+    return count == 0 || fwrite(data, size, count, f) == count;
+}
+
+/**
+ *  Return true if the path is the move and 4 cubics of GPathBuilder::addCircle, mapped by a
+ *  scale+translate matrix, setting oval to the points' bounds. Each cubic must run between two
+ *  perpendicular axis points a and b of the unit circle (turning the same way each time), with
+ *  controls a + kb and b + ka, once the points are mapped from the bounds onto [-1, 1].
+ */
+static bool is_oval(const GPathVerb vbs[], uint32_t vbCount, const GPoint pts[], uint32_t ptCount,
+                    GRect* oval) {
+    if (vbCount != 5 || ptCount != 13 || vbs[0] != kMove) {
+        return false;
+    }
+    for (uint32_t i = 1; i < vbCount; ++i) {
+        if (vbs[i] != kCubic) {
+            return false;
+        }
+    }
+    auto bounds = GRect::LTRB(pts[0].x, pts[0].y, pts[0].x, pts[0].y);
+    for (uint32_t i = 1; i < ptCount; ++i) {
+        bounds.left = std::min(bounds.left, pts[i].x);
+        bounds.top = std::min(bounds.top, pts[i].y);
+        bounds.right = std::max(bounds.right, pts[i].x);
+        bounds.bottom = std::max(bounds.bottom, pts[i].y);
+    }
+    auto rx = bounds.width() / 2, ry = bounds.height() / 2;
+    if (!(rx > 0 && ry > 0) || !std::isfinite(rx) || !std::isfinite(ry)) {
+        return false;
+    }
+    auto unit = [&](GPoint p) {
+        return GPoint{(p.x - bounds.left) / rx - 1, (p.y - bounds.top) / ry - 1};
+    };
+    const float kTol = 1.0f / 1024;
+    auto near = [kTol](GPoint p, GPoint q) {
+        return std::abs(p.x - q.x) <= kTol && std::abs(p.y - q.y) <= kTol;
+    };
+    auto isAxis = [kTol](GPoint p) {
+        return std::abs(std::abs(p.x) + std::abs(p.y) - 1) <= kTol && std::abs(p.x * p.y) <= kTol;
+    };
+
+    const float k = 0.551915f;
+    float turn = 0;
+    for (int i = 0; i < 12; i += 3) {
+        auto a = unit(pts[i]), b = unit(pts[i + 3]);
+        auto cross = a.x * b.y - a.y * b.x;
+        if (!isAxis(a) || !isAxis(b) || std::abs(a.x * b.x + a.y * b.y) > kTol ||
+            cross * turn < 0 || !near(unit(pts[i + 1]), a + k * b) ||
+            !near(unit(pts[i + 2]), b + k * a)) {
+            return false;
+        }
+        turn = cross;
+    }
+    if (pts[12] != pts[0]) {
+        return false;
+    }
+    *oval = bounds;
+    return true;
+}
+
+GPathPack::GPathPack(std::shared_ptr<const Mapping> mapping, int count)
+    : fMapping(std::move(mapping)), fCount(count) {
+    fRecords = reinterpret_cast<const Record*>(fMapping->data + sizeof(Header));
+}
+
+bool GPathPack::Write(const char file[], const GPath* const paths[], const GPaint paints[],
+                      int count) {
+    if (count < 0) {
+        return false;
+    }
+
+    //* lay out each path's points then verbs, padded so the next path's points stay aligned
+    std::vector<Record> records(count);
+    uint64_t offset = sizeof(Header) + count * sizeof(Record);
+    for (int i = 0; i < count; ++i) {
+        const auto& path = *paths[i];
+        auto paint = paints ? paints[i] : GPaint();
+        if (paint.peekShader()) {
+            return false;
+        }
+        auto& rec = records[i];
+        rec.ptsOffset = offset;
+        rec.ptCount = static_cast<uint32_t>(path.countPoints());
+        offset += rec.ptCount * sizeof(GPoint);
+        rec.vbsOffset = offset;
+        rec.vbCount = static_cast<uint32_t>(path.fData.vbCount);
+        offset += (rec.vbCount + 3) / 4 * 4;
+
+        auto c = paint.getColor();
+        rec.color[0] = c.r;
+        rec.color[1] = c.g;
+        rec.color[2] = c.b;
+        rec.color[3] = c.a;
+        rec.blendMode = static_cast<uint8_t>(paint.getBlendMode());
+        rec.flags = paint.isAntiAlias() ? kAntiAlias_Flag : 0;
+        GRect oval;
+        if (path.isOval(&oval)) {
+            rec.flags |= kOval_Flag;
+            rec.oval[0] = oval.left;
+            rec.oval[1] = oval.top;
+            rec.oval[2] = oval.right;
+            rec.oval[3] = oval.bottom;
+        }
+    }
+
+    FILE* f = fopen(file, "wb");
+    if (!f) {
+        return false;
+    }
+    const Header header = {kMagic, kVersion, static_cast<uint32_t>(count), 0};
+    bool ok = write_array(f, &header, sizeof(header), 1) &&
+              write_array(f, records.data(), sizeof(Record), count);
+    std::vector<GPoint> pts;
+    for (int i = 0; ok && i < count; ++i) {
+        const auto& path = *paths[i];
+        const auto& rec = records[i];
+        pts.resize(rec.ptCount);
+        for (size_t j = 0; j < pts.size(); ++j) {
+            pts[j] = path.point(j);
+        }
+        const uint8_t zeros[3] = {0, 0, 0};
+        ok = write_array(f, pts.data(), sizeof(GPoint), pts.size()) &&
+             write_array(f, path.fData.vbs, sizeof(GPathVerb), rec.vbCount) &&
+             write_array(f, zeros, 1, (4 - rec.vbCount % 4) % 4);
+    }
+    return fclose(f) == 0 && ok;
+}
+
+std::shared_ptr<GPathPack> GPathPack::Open(const char file[]) {
+    auto mapping = std::make_shared<Mapping>();
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        auto size = static_cast<size_t>(st.st_size);
+        auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            mapping->data = static_cast<const char*>(addr);
+            mapping->size = size;
+            mapping->mapped = true;
+        }
+    }
+    close(fd);
+#else
+    //* no mmap, so read the whole file instead
+    FILE* f = fopen(file, "rb");
+    if (!f) {
+        return nullptr;
+    }
+    if (fseek(f, 0, SEEK_END) == 0) {
+        auto size = ftell(f);
+        if (size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+            auto data = new char[size];
+            if (fread(data, 1, size, f) == static_cast<size_t>(size)) {
+                mapping->data = data;
+                mapping->size = size;
+            } else {
+                delete[] data;
+            }
+        }
+    }
+    fclose(f);
+#endif
+    if (mapping->size < sizeof(Header)) {
+        return nullptr;
+    }
+    auto header = reinterpret_cast<const Header*>(mapping->data);
+    if (header->magic != kMagic || header->version != kVersion || header->count > INT_MAX ||
+        header->count > (mapping->size - sizeof(Header)) / sizeof(Record)) {
+        return nullptr;
+    }
+    return std::shared_ptr<GPathPack>(new GPathPack(std::move(mapping), header->count));
+}
+
+std::shared_ptr<GPath> GPathPack::path(int index) const {
+    assert(index >= 0 && index < fCount);
+    const auto& rec = fRecords[index];
+    auto size = fMapping->size;
+    if (rec.ptsOffset % alignof(GPoint) != 0 || rec.ptsOffset > size ||
+        rec.ptCount > (size - rec.ptsOffset) / sizeof(GPoint) || rec.vbsOffset > size ||
+        rec.vbCount > size - rec.vbsOffset) {
+        return nullptr;
+    }
+
+    //* the verbs must start with a move, and use exactly the record's points
+    auto vbs = reinterpret_cast<const uint8_t*>(fMapping->data + rec.vbsOffset);
+    static const uint64_t kVerbPoints[] = {1, 1, 2, 3};  // for kMove, kLine, kQuad, kCubic
+    uint64_t ptCount = 0;
+    for (uint32_t i = 0; i < rec.vbCount; ++i) {
+        if (vbs[i] > kCubic || (i == 0 && vbs[i] != kMove)) {
+            return nullptr;
+        }
+        ptCount += kVerbPoints[vbs[i]];
+    }
+    if (ptCount != rec.ptCount) {
+        return nullptr;
+    }
+    //* the points must be finite (the rasterizers assume so), which pages them in
+    auto pts = reinterpret_cast<const GPoint*>(fMapping->data + rec.ptsOffset);
+    for (uint32_t i = 0; i < rec.ptCount; ++i) {
+        if (!std::isfinite(pts[i].x) || !std::isfinite(pts[i].y)) {
+            return nullptr;
+        }
+    }
+
+    GPath::Storage data;
+    data.ptsOwner = fMapping;
+    data.pts = pts;
+    data.ptCount = rec.ptCount;
+    data.vbsOwner = fMapping;
+    data.vbs = reinterpret_cast<const GPathVerb*>(vbs);
+    data.vbCount = rec.vbCount;
+    auto path = std::make_shared<GPath>(GPath::Key(), data);
+    //* the oval flag lets drawPath() call fillOval(), so check the points really are the oval
+    GRect oval;
+    if ((rec.flags & kOval_Flag) &&
+        is_oval(data.vbs, data.vbCount, data.pts, data.ptCount, &oval)) {
+        path->fIsOval = true;
+        path->fOval = oval;
+    }
+    return path;
+}
+
+GPaint GPathPack::paint(int index) const {
+    assert(index >= 0 && index < fCount);
+    const auto& rec = fRecords[index];
+    //* the color is pinned to [0, 1] (NaN to 0), as the blitters assume it is
+    auto unit = [](float x) { return x > 0 ? std::min(x, 1.0f) : 0.0f; };
+    GPaint paint(GColor::RGBA(unit(rec.color[0]), unit(rec.color[1]), unit(rec.color[2]),
+                              unit(rec.color[3])));
+    if (rec.blendMode <= static_cast<uint8_t>(GBlendMode::kXor)) {
+        paint.setBlendMode(static_cast<GBlendMode>(rec.blendMode));
+    }
+    paint.setAntiAlias((rec.flags & kAntiAlias_Flag) != 0);
+    return paint;
+}
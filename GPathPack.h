@@ -0,0 +1,53 @@
+#ifndef GPathPack_DEFINED
+#define GPathPack_DEFINED
+
+#include "include/GPaint.h"
+#include "include/GPath.h"
+#include <memory>
+
+/**
+ *  A file of paths, each with a paint, laid out so that Open() can map it into memory and hand
+ *  out paths that read their points and verbs straight from the mapping. Opening a pack reads
+ *  just its header and record table; each path's data is paged in when the path is first used.
+ *
+ *  Paints keep their color, blend mode and anti-aliasing, but not their shader. The file is in
+ *  native byte order (Open() rejects a pack written with the other one).
+ */
+class GPathPack {
+public:
+    /**
+     *  Write the [count] paths, with paints[i] for paths[i] (or default paints if paints is null),
+     *  to the file. Returns false if it could not be written, or if a paint has a shader.
+     */
+    static bool Write(const char file[], const GPath* const paths[], const GPaint paints[],
+                      int count);
+
+    /**
+     *  Map the file, returning null if it can't be read or its header or record table is invalid.
+     */
+    static std::shared_ptr<GPathPack> Open(const char file[]);
+
+    int count() const { return fCount; }
+
+    /**
+     *  Return a new path for the i'th record, sharing the mapped points and verbs (and keeping
+     *  the mapping alive), or null if the record's data is invalid (including non-finite points).
+     */
+    std::shared_ptr<GPath> path(int index) const;
+
+    // The i'th record's paint, its color components pinned to [0, 1] (and NaN to 0).
+    GPaint paint(int index) const;
+
+private:
+    struct Header;
+    struct Record;
+    struct Mapping;
+
+    GPathPack(std::shared_ptr<const Mapping>, int count);
+
+    std::shared_ptr<const Mapping> fMapping;
+    const Record* fRecords;
+    int fCount;
+};
+
+#endif
@@ -0,0 +1,322 @@
+#include "GSVGPath.h"
+#include "include/GMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static const char* skip_space(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == '\f')) {
+        ++p;
+    }
+    return p;
+}
+
+// skip the whitespace, and at most one comma, between two arguments
+static const char* skip_separator(const char* p, const char* end) {
+    p = skip_space(p, end);
+    if (p < end && *p == ',') {
+        p = skip_space(p + 1, end);
+    }
+    return p;
+}
+
+/**
+ *  Scan a number (e.g. "-1", "2.5", ".5e-3") at p, returning the end of it, or null if there
+ *  isn't one. The first 19 significant digits are gathered as an integer, which is then scaled
+ *  by an exact power of ten when it can be, so the result is as close as strtof's almost always.
+ */
+static const char* scan_number(const char* p, const char* end, float* value) {
+    static const double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p++ == '-';
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;  // significant digits in mantissa
+    int exponent = 0;
+    bool any = false;
+    for (; p < end && is_digit(*p); ++p) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            digits += mantissa != 0;
+        } else {
+            exponent += 1;
+        }
+        any = true;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && is_digit(*p); ++p) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                digits += mantissa != 0;
+                exponent -= 1;
+            }
+            any = true;
+        }
+    }
+    if (!any) {
+        return nullptr;
+    }
+    // an 'e' is only an exponent if digits follow it
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        auto q = p + 1;
+        bool negativeExp = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            negativeExp = *q++ == '-';
+        }
+        if (q < end && is_digit(*q)) {
+            int e = 0;
+            for (; q < end && is_digit(*q); ++q) {
+                e = std::min(e * 10 + (*q - '0'), 100000);
+            }
+            exponent += negativeExp ? -e : e;
+            p = q;
+        }
+    }
+
+    auto v = static_cast<double>(mantissa);
+    if (mantissa != 0 && exponent != 0) {
+        if (exponent > 0 && exponent <= 22) {
+            v *= kPow10[exponent];
+        } else if (exponent < 0 && exponent >= -22) {
+            v /= kPow10[-exponent];
+        } else {
+            v *= std::pow(10.0, exponent);
+        }
+    }
+    *value = static_cast<float>(negative ? -v : v);
+    return p;
+}
+
+// an arc's flags are single digits, which need not be separated from what follows them
+static const char* scan_flag(const char* p, const char* end, bool* flag) {
+    if (p < end && (*p == '0' || *p == '1')) {
+        *flag = *p == '1';
+        return p + 1;
+    }
+    return nullptr;
+}
+
+/**
+ *  Append the SVG arc from p0 to p1 as cubics, each turning at most a quarter of the ellipse
+ *  (converting from SVG's endpoint form to the ellipse's center, per the SVG spec's appendix).
+ */
+static void arc_to(GPathBuilder* bu, GPoint p0, float rx, float ry, float degrees, bool largeArc,
+                   bool sweep, GPoint p1) {
+    if (p0 == p1) {
+        return;
+    }
+    rx = std::abs(rx);
+    ry = std::abs(ry);
+    if (rx == 0 || ry == 0) {
+        bu->lineTo(p1);
+        return;
+    }
+    auto phi = degrees * gFloatPI / 180;
+    auto c = std::cos(phi);
+    auto s = std::sin(phi);
+
+    //* p0 relative to the chord's midpoint, in the ellipse's (unrotated) frame
+    auto hx = (p0.x - p1.x) * 0.5f;
+    auto hy = (p0.y - p1.y) * 0.5f;
+    auto x = c * hx + s * hy;
+    auto y = -s * hx + c * hy;
+    // grow the radii if they can't span the chord
+    auto lambda = (x * x) / (rx * rx) + (y * y) / (ry * ry);
+    if (lambda > 1) {
+        rx *= std::sqrt(lambda);
+        ry *= std::sqrt(lambda);
+    }
+    auto num = rx * rx * ry * ry - rx * rx * y * y - ry * ry * x * x;
+    auto den = rx * rx * y * y + ry * ry * x * x;
+    auto k = std::sqrt(std::max(0.0f, num / den)) * (largeArc == sweep ? -1 : 1);
+    auto cx = k * rx * y / ry;
+    auto cy = -k * ry * x / rx;
+
+    //* the arc's angles on the unit circle, which the ellipse's matrix maps onto it
+    auto theta = std::atan2((y - cy) / ry, (x - cx) / rx);
+    auto sweepAngle = std::atan2((-y - cy) / ry, (-x - cx) / rx) - theta;
+    if (sweep && sweepAngle < 0) {
+        sweepAngle += 2 * gFloatPI;
+    } else if (!sweep && sweepAngle > 0) {
+        sweepAngle -= 2 * gFloatPI;
+    }
+    auto mx = GMatrix::Translate((p0.x + p1.x) * 0.5f, (p0.y + p1.y) * 0.5f) *
+              GMatrix::Rotate(phi) * GMatrix::Translate(cx, cy) * GMatrix::Scale(rx, ry);
+
+    auto n = std::max(1, GCeilToInt(std::abs(sweepAngle) / (gFloatPI / 2) - 1e-3f));
+    auto step = sweepAngle / n;
+    // the control points of a cubic through an arc of step are this far along its tangents
+    auto t = 4.0f / 3 * std::tan(step / 4);
+    for (auto i = 0; i < n; ++i) {
+        auto a0 = theta + step * i;
+        auto a1 = a0 + step;
+        GPoint pts[3] = {
+            {std::cos(a0) - t * std::sin(a0), std::sin(a0) + t * std::cos(a0)},
+            {std::cos(a1) + t * std::sin(a1), std::sin(a1) - t * std::cos(a1)},
+            {std::cos(a1), std::sin(a1)},
+        };
+        mx.mapPoints(pts, 3);
+        if (i == n - 1) {
+            pts[2] = p1;
+        }
+        bu->cubicTo(pts[0], pts[1], pts[2]);
+    }
+}
+
+bool GParseSVGPath(const char data[], size_t length, GPathBuilder* bu) {
+    const char* p = data;
+    const char* end = data + length;
+    char cmd = 0;
+    char prevUpper = 0;     // the previous command, in upper case
+    GPoint curr = {0, 0};   // the current point
+    GPoint start = {0, 0};  // where the current contour started
+    GPoint ctrl = {0, 0};   // the last control point of the previous command, if it was a curve
+    bool needMove = false;  // after a close, the next command (but a move) starts at start
+
+    // read count points into pts, relative to curr for lower case commands
+    auto points = [&](GPoint pts[], int count) {
+        for (auto i = 0; i < count; ++i) {
+            GPoint pt;
+            if (!(p = scan_number(p, end, &pt.x)) ||
+                !(p = scan_number(skip_separator(p, end), end, &pt.y))) {
+                return false;
+            }
+            p = skip_separator(p, end);
+            pts[i] = cmd >= 'a' ? pt + curr : pt;
+        }
+        return true;
+    };
+    auto number = [&](float* v) {
+        if (!(p = scan_number(p, end, v))) {
+            return false;
+        }
+        p = skip_separator(p, end);
+        return true;
+    };
+    auto flag = [&](bool* f) {
+        if (!(p = scan_flag(p, end, f))) {
+            return false;
+        }
+        p = skip_separator(p, end);
+        return true;
+    };
+
+    p = skip_space(p, end);
+    while (p < end) {
+        //* a command letter, or more arguments for the previous command
+        if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
+            cmd = *p;
+            p = skip_space(p + 1, end);
+        } else if (cmd == 0 || cmd == 'Z' || cmd == 'z') {
+            return false;
+        }
+        auto upper = static_cast<char>(cmd & ~0x20);
+        auto relative = cmd >= 'a';
+        if (upper != 'M') {
+            if (prevUpper == 0) {
+                return false;  // the data must start with a move
+            }
+            if (needMove && upper != 'Z') {
+                bu->moveTo(start);
+                needMove = false;
+            }
+        }
+
+        GPoint pts[3];
+        float v[3];
+        bool large, sweep;
+        switch (upper) {
+            case 'M':
+                if (!points(pts, 1)) {
+                    return false;
+                }
+                bu->moveTo(pts[0]);
+                curr = start = pts[0];
+                needMove = false;
+                // any more points are lines
+                cmd = relative ? 'l' : 'L';
+                break;
+            case 'L':
+                if (!points(pts, 1)) {
+                    return false;
+                }
+                bu->lineTo(pts[0]);
+                curr = pts[0];
+                break;
+            case 'H':
+                if (!number(&v[0])) {
+                    return false;
+                }
+                curr.x = relative ? curr.x + v[0] : v[0];
+                bu->lineTo(curr);
+                break;
+            case 'V':
+                if (!number(&v[0])) {
+                    return false;
+                }
+                curr.y = relative ? curr.y + v[0] : v[0];
+                bu->lineTo(curr);
+                break;
+            case 'C':
+                if (!points(pts, 3)) {
+                    return false;
+                }
+                bu->cubicTo(pts[0], pts[1], pts[2]);
+                ctrl = pts[1];
+                curr = pts[2];
+                break;
+            case 'S':
+                // the first control point reflects the previous cubic's last one
+                if (!points(pts + 1, 2)) {
+                    return false;
+                }
+                pts[0] = prevUpper == 'C' || prevUpper == 'S' ? curr + (curr - ctrl) : curr;
+                bu->cubicTo(pts[0], pts[1], pts[2]);
+                ctrl = pts[1];
+                curr = pts[2];
+                break;
+            case 'Q':
+                if (!points(pts, 2)) {
+                    return false;
+                }
+                bu->quadTo(pts[0], pts[1]);
+                ctrl = pts[0];
+                curr = pts[1];
+                break;
+            case 'T':
+                // the control point reflects the previous quadratic's
+                if (!points(pts + 1, 1)) {
+                    return false;
+                }
+                pts[0] = prevUpper == 'Q' || prevUpper == 'T' ? curr + (curr - ctrl) : curr;
+                bu->quadTo(pts[0], pts[1]);
+                ctrl = pts[0];
+                curr = pts[1];
+                break;
+            case 'A':
+                if (!number(&v[0]) || !number(&v[1]) || !number(&v[2]) || !flag(&large) ||
+                    !flag(&sweep) || !points(pts, 1)) {
+                    return false;
+                }
+                arc_to(bu, curr, v[0], v[1], v[2], large, sweep, pts[0]);
+                curr = pts[0];
+                break;
+            case 'Z':
+                if (curr != start) {
+                    bu->lineTo(start);
+                }
+                curr = start;
+                needMove = true;
+                break;
+            default:
+                return false;
+        }
+        prevUpper = upper;
+    }
+    return true;
+}
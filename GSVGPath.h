@@ -0,0 +1,18 @@
+#ifndef GSVGPath_DEFINED
+#define GSVGPath_DEFINED
+
+#include "include/GPathBuilder.h"
+#include <cstddef>
+
+/**
+ *  Parse SVG path data (the "d" attribute of a <path>) and append it to the builder: moves,
+ *  lines (L, H, V), quadratic and cubic beziers (Q, T, C, S), elliptical arcs (A, as cubics) and
+ *  closes (Z, as a line back to the contour's start), each absolute or relative (lower case).
+ *
+ *  Numbers are scanned by hand rather than by strtod, so they are read the same way whatever
+ *  the locale. Returns false at the first error, keeping what was parsed up to it (as SVG
+ *  renderers do).
+ */
+bool GParseSVGPath(const char data[], size_t length, GPathBuilder* builder);
+
+#endif
@@ -4,17 +4,45 @@
 #include "include/GMatrix.h"
 #include "include/GPixel.h"
 #include "include/GPoint.h"
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 class MyShader : public GShader {
 public:
     MyShader(GBitmap bitmap, GMatrix localMatrix, GTileMode tileMode)
         : bitmap(bitmap), localMatrix(*localMatrix.invert()), tileMode(tileMode) {}
     bool isOpaque() override { return bitmap.isOpaque(); }
 
+    nonstd::optional<GPixel> asConstantColor() override {
+        if (bitmap.width() == 1 && bitmap.height() == 1) {
+            return *bitmap.getAddr(0, 0);
+        }
+        return {};
+    }
+
+    bool asAffineBitmap(GBitmap* bm, int* dx, int* dy) override {
+        if (tileMode != GTileMode::kClamp || !localMatrix.isTranslate()) {
+            return false;
+        }
+        // x + 0.5 + e floors to x + floor(0.5 + e), so any translate lands on whole pixels
+        *bm = bitmap;
+        *dx = static_cast<int>(std::floor(0.5 + localMatrix[4]));
+        *dy = static_cast<int>(std::floor(0.5 + localMatrix[5]));
+        return true;
+    }
+
+    bool isRowConstant() override { return localMatrix[0] == 0 && localMatrix[1] == 0; }
+
+    bool isColumnConstant() override { return localMatrix[2] == 0 && localMatrix[3] == 0; }
+
     bool setContext(const GMatrix& ctm) override {
+        cachedCount = 0;
         auto result = ctm.invert();
         if (result.has_value()) {
             localMatrix = localMatrix * *result;
@@ -26,45 +54,47 @@ public:
     void shadeRow(int x, int y, int count, GPixel row[]) override {
         auto px = localMatrix[0] * (x + 0.5) + localMatrix[2] * (y + 0.5) + localMatrix[4];
         auto py = localMatrix[1] * (x + 0.5) + localMatrix[3] * (y + 0.5) + localMatrix[5];
-        for (int i = 0; i < count; ++i) {
-            auto ix = px;
-            auto iy = py;
-            // clamp
-            switch (tileMode) {
-            case GTileMode::kClamp:
-                if (ix < 0)
-                    ix = 0;
-                if (ix >= bitmap.width())
-                    ix = bitmap.width() - 1;
-                if (iy < 0)
-                    iy = 0;
-                if (iy >= bitmap.height())
-                    iy = bitmap.height() - 1;
-                break;
-            case GTileMode::kRepeat:
-                if (ix < 0)
-                    ix = bitmap.width() - std::abs(GRoundToInt(ix)) % (bitmap.width()) - 1;
-                else
-                    ix = std::abs(GRoundToInt(ix)) % bitmap.width();
-                if (iy < 0)
-                    iy = bitmap.height() - std::abs(GRoundToInt(iy)) % (bitmap.height()) - 1;
-                else
-                    iy = std::abs(GRoundToInt(iy)) % bitmap.height();
-                break;
-            case GTileMode::kMirror:
-                ix = std::abs(GRoundToInt(ix) % (2 * bitmap.width()));
-                iy = std::abs(GRoundToInt(iy) % (2 * bitmap.height()));
-                if (ix >= bitmap.width())
-                    ix = 2 * bitmap.width() - ix - 1;
-                if (iy >= bitmap.height())
-                    iy = 2 * bitmap.height() - iy - 1;
-                break;
+
+        //* scale+translate: the whole row samples a single src row
+        if (localMatrix[1] == 0 && localMatrix[2] == 0) {
+            auto iy = tile(py, bitmap.height());
+            // when magnifying, consecutive device rows often land on the same src row
+            auto reuse = std::abs(localMatrix[3]) < 1;
+            if (reuse && cachedCount == count && cachedX == x && cachedSrcY == iy) {
+                std::copy(cachedRow.begin(), cachedRow.end(), row);
+                return;
             }
+            auto src = bitmap.getAddr(0, iy);
+            for (int i = 0; i < count; ++i) {
+                row[i] = src[tile(px, bitmap.width())];
+                px += localMatrix[0];
+            }
+            if (reuse) {
+                cachedRow.assign(row, row + count);
+                cachedX = x;
+                cachedSrcY = iy;
+                cachedCount = count;
+            }
+            return;
+        }
 
-            // floor
-            row[i] = *bitmap.getAddr(GFloorToInt(ix), GFloorToInt(iy));
+        //* rotated/skewed: walking the src diagonally misses cache on nearly every pixel in a
+        //* row-major bitmap, so large bitmaps are sampled from an 8x8 tiled copy instead
+        if (bitmap.width() * bitmap.height() >= kTiledMinPixels) {
+            if (tiledPixels.empty()) {
+                buildTiled();
+            }
+            for (int i = 0; i < count; ++i) {
+                auto idx = tiledIndex(tile(px, bitmap.width()), tile(py, bitmap.height()));
+                row[i] = tiledPixels[idx];
+                px += localMatrix[0];
+                py += localMatrix[1];
+            }
+            return;
+        }
 
-            // TODO: optimize the case when a or b is constant
+        for (int i = 0; i < count; ++i) {
+            row[i] = *bitmap.getAddr(tile(px, bitmap.width()), tile(py, bitmap.height()));
             px += localMatrix[0];
             py += localMatrix[1];
         }
@@ -74,6 +104,62 @@ private:
     GBitmap bitmap;
     GMatrix localMatrix;
     GTileMode tileMode;
+
+    // the last row shaded while magnifying, keyed by (x, count, src y)
+    std::vector<GPixel> cachedRow;
+    int cachedX = 0;
+    int cachedSrcY = 0;
+    int cachedCount = 0;
+
+    // copy of the bitmap in 8x8 tiles, built the first time we sample it rotated (like the
+    // bitmap itself, its pixels are assumed not to change once the shader is drawing)
+    static constexpr int kTileShift = 3;
+    static constexpr int kTiledMinPixels = 256 * 256;
+    std::vector<GPixel> tiledPixels;
+    int tilesPerRow = 0;
+
+    int tiledIndex(int x, int y) const {
+        auto tileIdx = (y >> kTileShift) * tilesPerRow + (x >> kTileShift);
+        auto mask = (1 << kTileShift) - 1;
+        return (tileIdx << (2 * kTileShift)) + ((y & mask) << kTileShift) + (x & mask);
+    }
+
+    void buildTiled() {
+        auto size = 1 << kTileShift;
+        tilesPerRow = (bitmap.width() + size - 1) >> kTileShift;
+        auto tileRows = (bitmap.height() + size - 1) >> kTileShift;
+        tiledPixels.assign(static_cast<size_t>(tilesPerRow) * tileRows * size * size, 0);
+        for (auto y = 0; y < bitmap.height(); y++) {
+            auto src = bitmap.getAddr(0, y);
+            for (auto x = 0; x < bitmap.width(); x++) {
+                tiledPixels[tiledIndex(x, y)] = src[x];
+            }
+        }
+    }
+
+    // Map a local coordinate to a pixel index along an axis of the given size.
+    int tile(double v, int size) const {
+        switch (tileMode) {
+        case GTileMode::kClamp:
+            if (v < 0)
+                v = 0;
+            if (v >= size)
+                v = size - 1;
+            break;
+        case GTileMode::kRepeat:
+            if (v < 0)
+                v = size - std::abs(GRoundToInt(v)) % size - 1;
+            else
+                v = std::abs(GRoundToInt(v)) % size;
+            break;
+        case GTileMode::kMirror:
+            v = std::abs(GRoundToInt(v) % (2 * size));
+            if (v >= size)
+                v = 2 * size - v - 1;
+            break;
+        }
+        return GFloorToInt(v);
+    }
 };
 
 std::shared_ptr<GShader> GCreateBitmapShader(const GBitmap& bitmap, const GMatrix& localMatrix,
@@ -108,6 +194,21 @@ public:
         return true;
     }
 
+    nonstd::optional<GPixel> asConstantColor() override {
+        for (auto& color : colors) {
+            if (color != colors[0])
+                return {};
+        }
+        auto c = colors[0];
+        return GPixel_PackARGB(GRoundToInt(c.a * 255), GRoundToInt(c.r * c.a * 255),
+                               GRoundToInt(c.g * c.a * 255), GRoundToInt(c.b * c.a * 255));
+    }
+
+    //* the gradient only depends on the x component of the local matrix
+    bool isRowConstant() override { return localMatrix[0] == 0; }
+
+    bool isColumnConstant() override { return localMatrix[2] == 0; }
+
     bool setContext(const GMatrix& ctm) override {
         auto result = ctm.invert();
         if (result.has_value()) {
@@ -145,8 +246,11 @@ public:
             }
             }
 
-            auto t = ix - GFloorToInt(ix);
-            auto c = (1 - t) * colors[GFloorToInt(ix)] + t * colors[GFloorToInt(ix) + 1];
+            // the last color is reached with t == 1, so k + 1 never runs past the end
+            auto last = static_cast<int>(colors.size()) - 1;
+            auto k = std::max(0, std::min(GFloorToInt(ix), last - 1));
+            auto t = ix - k;
+            auto c = (1 - t) * colors[k] + t * colors[std::min(k + 1, last)];
 
             // floor
             row[i] = GPixel_PackARGB(GRoundToInt(c.a * 255), GRoundToInt(c.r * c.a * 255),
@@ -166,3 +270,161 @@ std::shared_ptr<GShader> GCreateLinearGradient(GPoint p0, GPoint p1, const GColo
     return std::make_unique<MyLinearGradientShader>(
         MyLinearGradientShader(p0, p1, colors, count, tileMode));
 }
+
+/**
+ *  Common state for the radial and sweep gradients: the colors are interpolated and
+ *  premultiplied once into a table indexed by t in [0, 1], so shading a pixel is just computing
+ *  t, tiling it (like the linear gradient) and a lookup.
+ */
+class MyLUTGradientShader : public GShader {
+public:
+    MyLUTGradientShader(GMatrix unitToLocal, const GColor colors[], int count, GTileMode tileMode)
+        : localMatrix(*unitToLocal.invert()), colors(colors, colors + count), tileMode(tileMode) {
+        for (auto i = 0; i < kLUTSize; i++) {
+            auto u = static_cast<float>(i) / (kLUTSize - 1) * (count - 1);
+            auto k = std::min(GFloorToInt(u), std::max(count - 2, 0));
+            auto c = count == 1 ? colors[0] : (1 - (u - k)) * colors[k] + (u - k) * colors[k + 1];
+            lut[i] = GPixel_PackARGB(GRoundToInt(c.a * 255), GRoundToInt(c.r * c.a * 255),
+                                     GRoundToInt(c.g * c.a * 255), GRoundToInt(c.b * c.a * 255));
+        }
+    }
+
+    bool isOpaque() override {
+        for (auto& color : colors) {
+            if (color.a < 1)
+                return false;
+        }
+        return true;
+    }
+
+    nonstd::optional<GPixel> asConstantColor() override {
+        for (auto& color : colors) {
+            if (color != colors[0])
+                return {};
+        }
+        return lut[0];
+    }
+
+    bool setContext(const GMatrix& ctm) override {
+        auto result = ctm.invert();
+        if (result.has_value()) {
+            localMatrix = localMatrix * *result;
+            return true;
+        }
+        return false;
+    }
+
+protected:
+    static constexpr int kLUTSize = 256;
+
+    GMatrix localMatrix;
+
+    GPixel lookup(float t) const {
+        switch (tileMode) {
+        case GTileMode::kClamp:
+            t = GPinToUnit(t);
+            break;
+        case GTileMode::kRepeat:
+            t = t - std::floor(t);
+            break;
+        case GTileMode::kMirror:
+            t = std::abs(t);
+            t = t - 2 * std::floor(t * 0.5f);
+            if (t > 1)
+                t = 2 - t;
+            break;
+        }
+        return lut[GRoundToInt(t * (kLUTSize - 1))];
+    }
+
+private:
+    std::vector<GColor> colors;
+    GTileMode tileMode;
+    GPixel lut[kLUTSize];
+};
+
+static inline float fast_sqrt(float x) {
+#ifdef __SSE2__
+    //* a single sqrtss, without the errno handling of the libm call
+    return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+#else
+    return std::sqrt(x);
+#endif
+}
+
+// Polynomial atan2, accurate to about 1e-5 radians. Returns [-pi, pi].
+static inline float fast_atan2(float y, float x) {
+    auto ax = std::abs(x);
+    auto ay = std::abs(y);
+    auto hi = std::max(ax, ay);
+    if (hi == 0)
+        return 0;
+    auto a = std::min(ax, ay) / hi;
+    auto s = a * a;
+    auto r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    if (ay > ax)
+        r = gFloatPI / 2 - r;
+    if (x < 0)
+        r = gFloatPI - r;
+    return y < 0 ? -r : r;
+}
+
+class MyRadialGradientShader : public MyLUTGradientShader {
+public:
+    MyRadialGradientShader(GPoint center, float radius, const GColor colors[], int count,
+                           GTileMode tileMode)
+        : MyLUTGradientShader(GMatrix({radius, 0}, {0, radius}, center), colors, count,
+                              tileMode) {}
+
+    void shadeRow(int x, int y, int count, GPixel row[]) override {
+        auto a = localMatrix[0];
+        auto b = localMatrix[1];
+        auto px = a * (x + 0.5f) + localMatrix[2] * (y + 0.5f) + localMatrix[4];
+        auto py = b * (x + 0.5f) + localMatrix[3] * (y + 0.5f) + localMatrix[5];
+
+        //* forward difference the squared distance: d2(i + 1) = d2(i) + dd(i), dd += ddd
+        double d2 = px * px + py * py;
+        double dd = 2 * (px * a + py * b) + a * a + b * b;
+        double ddd = 2 * (a * a + b * b);
+        for (int i = 0; i < count; ++i) {
+            row[i] = lookup(fast_sqrt(static_cast<float>(std::max(d2, 0.0))));
+            d2 += dd;
+            dd += ddd;
+        }
+    }
+};
+
+class MySweepGradientShader : public MyLUTGradientShader {
+public:
+    MySweepGradientShader(GPoint center, float startRadians, const GColor colors[], int count)
+        : MyLUTGradientShader(GMatrix::Translate(center.x, center.y) *
+                                  GMatrix::Rotate(startRadians),
+                              colors, count, GTileMode::kClamp) {}
+
+    void shadeRow(int x, int y, int count, GPixel row[]) override {
+        auto px = localMatrix[0] * (x + 0.5f) + localMatrix[2] * (y + 0.5f) + localMatrix[4];
+        auto py = localMatrix[1] * (x + 0.5f) + localMatrix[3] * (y + 0.5f) + localMatrix[5];
+        for (int i = 0; i < count; ++i) {
+            auto t = fast_atan2(py, px) * (0.5f / gFloatPI);
+            row[i] = lookup(t < 0 ? t + 1 : t);
+            px += localMatrix[0];
+            py += localMatrix[1];
+        }
+    }
+};
+
+std::shared_ptr<GShader> GCreateRadialGradient(GPoint center, float radius, const GColor colors[],
+                                               int count, GTileMode tileMode) {
+    if (count < 1 || radius <= 0) {
+        return nullptr;
+    }
+    return std::make_shared<MyRadialGradientShader>(center, radius, colors, count, tileMode);
+}
+
+std::shared_ptr<GShader> GCreateSweepGradient(GPoint center, float startRadians,
+                                              const GColor colors[], int count) {
+    if (count < 1) {
+        return nullptr;
+    }
+    return std::make_shared<MySweepGradientShader>(center, startRadians, colors, count);
+}
@@ -0,0 +1,107 @@
+#ifndef GStaticPath_DEFINED
+#define GStaticPath_DEFINED
+
+#include "include/GPath.h"
+#include "include/GRect.h"
+#include <cassert>
+#include <cstddef>
+
+/**
+ *  A path builder with room for MaxPoints points and MaxVerbs verbs, whose methods are constexpr,
+ *  so a path of fixed geometry (an icon, a logo) can be built when compiling into a static array,
+ *  and drawn through view() with nothing built or allocated at runtime:
+ *
+ *      static constexpr auto kIcon = [] {
+ *          GStaticPathBuilder<4> bu;
+ *          bu.moveTo(0, 0);
+ *          ...
+ *          return bu;
+ *      }();
+ *      static const GPath icon = kIcon.view();
+ *      canvas->drawPath(icon, paint);
+ *
+ *  Overflowing the capacity fails an assert (or, at compile time, fails to compile).
+ */
+template <size_t MaxPoints, size_t MaxVerbs = MaxPoints> class GStaticPathBuilder {
+public:
+    constexpr GStaticPathBuilder() {}
+
+    constexpr void moveTo(GPoint p) {
+        this->add(kMove, &p, 1);
+    }
+    constexpr void moveTo(float x, float y) { this->moveTo({x, y}); }
+
+    constexpr void lineTo(GPoint p) {
+        assert(fVbCount > 0);
+        this->add(kLine, &p, 1);
+    }
+    constexpr void lineTo(float x, float y) { this->lineTo({x, y}); }
+
+    constexpr void quadTo(GPoint p1, GPoint p2) {
+        assert(fVbCount > 0);
+        const GPoint pts[] = {p1, p2};
+        this->add(kQuad, pts, 2);
+    }
+    constexpr void quadTo(float x1, float y1, float x2, float y2) {
+        this->quadTo({x1, y1}, {x2, y2});
+    }
+
+    constexpr void cubicTo(GPoint p1, GPoint p2, GPoint p3) {
+        assert(fVbCount > 0);
+        const GPoint pts[] = {p1, p2, p3};
+        this->add(kCubic, pts, 3);
+    }
+    constexpr void cubicTo(float x1, float y1, float x2, float y2, float x3, float y3) {
+        this->cubicTo({x1, y1}, {x2, y2}, {x3, y3});
+    }
+
+    // as GPathBuilder::addRect: a contour of the rect's corners, starting at its top-left
+    constexpr void addRect(const GRect& r, GPathDirection dir = GPathDirection::kCW) {
+        this->moveTo(r.left, r.top);
+        if (dir == GPathDirection::kCW) {
+            this->lineTo(r.right, r.top);
+            this->lineTo(r.right, r.bottom);
+            this->lineTo(r.left, r.bottom);
+        } else {
+            this->lineTo(r.left, r.bottom);
+            this->lineTo(r.right, r.bottom);
+            this->lineTo(r.right, r.top);
+        }
+    }
+
+    // as GPathBuilder::addPolygon: moveTo(pts[0]), then lineTo(pts[1..count-1])
+    constexpr void addPolygon(const GPoint pts[], int count) {
+        if (count < 1) {
+            return;
+        }
+        this->moveTo(pts[0]);
+        for (int i = 1; i < count; ++i) {
+            this->lineTo(pts[i]);
+        }
+    }
+
+    constexpr size_t countPoints() const { return fPtCount; }
+    constexpr size_t countVerbs() const { return fVbCount; }
+
+    /**
+     *  Return a path reading this builder's points and verbs in place (see GPath::View), so the
+     *  builder must outlive it: make the builder static (ideally constexpr) and the path too.
+     */
+    GPath view() const { return GPath::View(fPts, fPtCount, fVbs, fVbCount); }
+
+private:
+    GPoint    fPts[MaxPoints] = {};
+    GPathVerb fVbs[MaxVerbs] = {};
+    size_t    fPtCount = 0;
+    size_t    fVbCount = 0;
+
+    constexpr void add(GPathVerb verb, const GPoint pts[], size_t count) {
+        assert(fVbCount < MaxVerbs && fPtCount + count <= MaxPoints);
+        fVbs[fVbCount++] = verb;
+        for (size_t i = 0; i < count; ++i) {
+            fPts[fPtCount++] = pts[i];
+        }
+    }
+};
+
+#endif
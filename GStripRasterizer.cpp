@@ -0,0 +1,147 @@
+#include "GStripRasterizer.h"
+#include "GAreaRasterizer.h"
+#include "include/GMath.h"
+#include "include/GMatrix.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+
+GStripRasterizer::GStripRasterizer(GISize device)
+    : fSize(device), fStrips((std::max(0, device.height) + kStripHeight - 1) >> kStripShift) {}
+
+void GStripRasterizer::addPath(const GPath& path) {
+    flatten_path(path, [this](GPoint p0, GPoint p1) { addLine(p0, p1); });
+}
+
+void GStripRasterizer::addLine(GPoint p0, GPoint p1) {
+    if (p0.y == p1.y) {
+        return;
+    }
+    auto top = std::max(0.0f, std::min(p0.y, p1.y));
+    auto bottom = std::min(static_cast<float>(fSize.height), std::max(p0.y, p1.y));
+    if (top >= bottom) {
+        return;
+    }
+
+    //* cut the line at every strip boundary, keeping its direction (and so its winding)
+    auto dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    auto at = [&](float y) { return GPoint{p0.x + (y - p0.y) * dxdy, y}; };
+    for (auto s = GFloorToInt(top) >> kStripShift; s < static_cast<int>(fStrips.size()); s++) {
+        float stripTop = s << kStripShift;
+        if (stripTop >= bottom) {
+            break;
+        }
+        auto a = at(std::max(top, stripTop));
+        auto b = at(std::min(bottom, stripTop + kStripHeight));
+        if (p0.y < p1.y) {
+            addStripLine(s, a, b);
+        } else {
+            addStripLine(s, b, a);
+        }
+    }
+}
+
+void GStripRasterizer::addStripLine(int strip, GPoint p0, GPoint p1) {
+    if (p0.y == p1.y) {
+        return;
+    }
+    float w = fSize.width;
+    auto lo = std::max(0.0f, std::min(p0.x, p1.x));
+    auto hi = std::min(w, std::max(p0.x, p1.x));
+
+    // where the line crosses tile boundaries (and x = 0 / x = width), in t
+    std::vector<float> ts = {0};
+    if (p0.x != p1.x) {
+        auto cross = [&](float x) {
+            auto t = (x - p0.x) / (p1.x - p0.x);
+            if (t > 0 && t < 1) {
+                ts.push_back(t);
+            }
+        };
+        cross(0);
+        cross(w);
+        for (auto k = (GFloorToInt(lo) >> kTileShift) + 1; (k << kTileShift) < hi; k++) {
+            cross(static_cast<float>(k << kTileShift));
+        }
+        std::sort(ts.begin(), ts.end());
+    }
+    ts.push_back(1);
+
+    for (size_t i = 0; i + 1 < ts.size(); i++) {
+        auto a = i == 0 ? p0 : p0 + ts[i] * (p1 - p0);
+        auto b = i + 2 == ts.size() ? p1 : p0 + ts[i + 1] * (p1 - p0);
+        auto mid = 0.5f * (a.x + b.x);
+        if (mid >= w) {
+            // only affects pixels further right, which are off the device
+            continue;
+        }
+        // left of the device, the piece is projected onto x = 0 where it still adds cover
+        a.x = std::max(0.0f, a.x);
+        b.x = std::max(0.0f, b.x);
+        fStrips[strip].push_back({std::max(0, GFloorToInt(mid)) >> kTileShift, a, b});
+    }
+}
+
+void GStripRasterizer::blit(const GPaint& paint, const GBitmap& device) {
+    constexpr int kStride = kTileWidth + 2;
+    float acc[kStripHeight * kStride] = {};
+    uint8_t coverage[kStride];
+    std::vector<uint8_t> spanCoverage;
+
+    for (size_t s = 0; s < fStrips.size(); s++) {
+        auto& pieces = fStrips[s];
+        if (pieces.empty()) {
+            continue;
+        }
+        std::stable_sort(pieces.begin(), pieces.end(),
+                         [](const Piece& a, const Piece& b) { return a.tile < b.tile; });
+
+        int stripTop = static_cast<int>(s) << kStripShift;
+        auto rows = std::min(kStripHeight, fSize.height - stripTop);
+        float backdrop[kStripHeight] = {};
+
+        // fill [from, to) on every row of the strip from the winding carried in from the left
+        auto fillSpan = [&](int from, int to) {
+            if (from >= to)
+                return;
+            for (auto r = 0; r < rows; r++) {
+                auto cov = static_cast<int>(std::min(1.0f, std::abs(backdrop[r])) * 255 + 0.5f);
+                if (cov == 255) {
+                    blend_row(from, stripTop + r, to - from, paint, device, GMatrix());
+                } else if (cov != 0) {
+                    spanCoverage.assign(to - from, static_cast<uint8_t>(cov));
+                    blend_anti_row(from, stripTop + r, to - from, spanCoverage.data(), paint,
+                                   device);
+                }
+            }
+        };
+
+        int filled = 0;
+        for (size_t i = 0; i < pieces.size();) {
+            auto tile = pieces[i].tile;
+            auto tileLeft = tile << kTileShift;
+            fillSpan(filled, tileLeft);
+
+            GPoint origin = {static_cast<float>(tileLeft), static_cast<float>(stripTop)};
+            for (; i < pieces.size() && pieces[i].tile == tile; i++) {
+                auto clampX = [](GPoint p) {
+                    return GPoint{std::max(0.0f, std::min(static_cast<float>(kTileWidth), p.x)),
+                                  p.y};
+                };
+                accumulate_line(acc, kStride, {kTileWidth, rows}, clampX(pieces[i].p0 - origin),
+                                clampX(pieces[i].p1 - origin), nullptr, nullptr);
+            }
+
+            auto count = std::min(kTileWidth, fSize.width - tileLeft);
+            for (auto r = 0; r < rows; r++) {
+                backdrop[r] = resolve_coverage_row(acc + r * kStride, coverage, kStride,
+                                                   backdrop[r]);
+                blend_anti_row(tileLeft, stripTop + r, count, coverage, paint, device);
+            }
+            filled = tileLeft + kTileWidth;
+        }
+        // paths that continue past the right side of the device leave a backdrop behind
+        fillSpan(filled, fSize.width);
+        pieces.clear();
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef GStripRasterizer_DEFINED
+#define GStripRasterizer_DEFINED
+
+#include "include/GBitmap.h"
+#include "include/GPaint.h"
+#include "include/GPath.h"
+#include "include/GPoint.h"
+#include <vector>
+
+/**
+ *  Anti-aliased rasterizer for large paths, built on sparse strips.
+ *
+ *  The device is split into strips 4 pixels tall, and each strip into tiles 16 pixels wide.
+ *  Line segments are binned into the tiles they touch, and only those tiles compute per-pixel
+ *  area coverage (see accumulate_line). The winding that leaves a tile's right side (its
+ *  "backdrop") is carried to the next touched tile, so the untouched tiles in between are
+ *  filled as solid spans without looking at any edges.
+ *
+ *  Tiles are 16x4 (one strip tall) rather than 16x16: the backdrop differs from one row of a
+ *  tile to the next, so a taller tile would still carry it per row, and would compute coverage
+ *  for 16 rows where an edge may only touch a few of them.
+ */
+class GStripRasterizer {
+public:
+    static constexpr int kStripShift = 2;
+    static constexpr int kStripHeight = 1 << kStripShift;
+    static constexpr int kTileShift = 4;
+    static constexpr int kTileWidth = 1 << kTileShift;
+
+    explicit GStripRasterizer(GISize device);
+
+    // Add the edges of the (device space) path, flattening curves into lines.
+    void addPath(const GPath&);
+
+    void addLine(GPoint p0, GPoint p1);
+
+    // Resolve the strips and blend the paint into the device with the resulting coverage.
+    void blit(const GPaint&, const GBitmap& device);
+
+private:
+    // part of a line inside one tile, in device space
+    struct Piece {
+        int tile;
+        GPoint p0, p1;
+    };
+
+    GISize fSize;
+    std::vector<std::vector<Piece>> fStrips;
+
+    // split a line that lies within one strip at the tile boundaries
+    void addStripLine(int strip, GPoint p0, GPoint p1);
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "GStroker.h"
+#include "include/GMath.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+static GVector normalize(GVector v) {
+    auto len = v.length();
+    return len > 0 ? v * (1 / len) : GVector{0, 0};
+}
+
+static float cross(GVector a, GVector b) { return a.x * b.y - a.y * b.x; }
+
+static float dot(GVector a, GVector b) { return a.x * b.x + a.y * b.y; }
+
+// the angle the direction turns through, going from a to b
+static float turn(GVector a, GVector b) { return std::atan2(std::abs(cross(a, b)), dot(a, b)); }
+
+// the total turn along a control polygon, skipping its zero-length legs
+static float polygonTurn(const GPoint pts[], int count) {
+    float total = 0;
+    GVector prev = {0, 0};
+    for (auto i = 1; i < count; i++) {
+        auto leg = pts[i] - pts[i - 1];
+        if (leg.x == 0 && leg.y == 0) {
+            continue;
+        }
+        if (prev.x != 0 || prev.y != 0) {
+            total += turn(prev, leg);
+        }
+        prev = leg;
+    }
+    return total;
+}
+
+GStroker::GStroker(const GStroke& stroke, float tolerance)
+    : fStroke(stroke), fRadius(std::abs(stroke.width) * 0.5f),
+      fTolerance(std::max(tolerance, 1e-4f)) {
+    //* a chord of a circle of radius r, turning through a, is within r(1 - cos(a/2)) of it
+    fMaxTurn = fTolerance < fRadius ? 2 * std::acos(1 - fTolerance / fRadius) : gFloatPI / 2;
+    fCircleSegments = std::min(256, std::max(4, GCeilToInt(2 * gFloatPI / fMaxTurn)));
+}
+
+void GStroker::addPath(const GPath& path) {
+    if (fRadius == 0) {
+        return;
+    }
+    GPath::Iter iter(path);
+    GPoint pts[GPath::kMaxNextPoints];
+    while (auto v = iter.next(pts)) {
+        switch (v.value()) {
+        case GPathVerb::kMove:
+            finishContour();
+            fContour.push_back(pts[0]);
+            fSmooth.push_back(false);
+            break;
+        case GPathVerb::kLine:
+            lineTo(pts[1], false);
+            break;
+        case GPathVerb::kQuad:
+            quadTo(pts);
+            break;
+        case GPathVerb::kCubic:
+            cubicTo(pts);
+            break;
+        }
+    }
+    finishContour();
+}
+
+void GStroker::lineTo(GPoint p, bool smooth) {
+    if (fContour.empty() || p == fContour.back()) {
+        return;
+    }
+    fContour.push_back(p);
+    fSmooth.push_back(smooth);
+}
+
+void GStroker::quadTo(const GPoint pts[3]) {
+    // P(t) = A + t(b + t a), and a chord of 1/n of it is within |a| / (4 n^2)
+    auto A = pts[0];
+    auto b = 2 * (pts[1] - A);
+    auto a = A - 2 * pts[1] + pts[2];
+    auto n = GCeilToInt(std::sqrt(a.length() / (4 * fTolerance)));
+    n = std::max(n, GCeilToInt(polygonTurn(pts, 3) / fMaxTurn));
+    n = std::min(kMaxCurveSegments, std::max(1, n));
+    for (auto i = 1; i < n; i++) {
+        auto t = static_cast<float>(i) / n;
+        lineTo(A + t * (b + t * a), true);
+    }
+    lineTo(pts[2], false);
+}
+
+void GStroker::cubicTo(const GPoint pts[4]) {
+    // P(t) = A + t(c + t(b + t a)), and a chord of 1/n of it is within 3|E| / (4 n^2)
+    auto A = pts[0];
+    auto a = pts[3] - A + 3 * (pts[1] - pts[2]);
+    auto b = 3 * (A - 2 * pts[1] + pts[2]);
+    auto c = 3 * (pts[1] - A);
+    auto E0 = A - 2 * pts[1] + pts[2];
+    auto E1 = pts[1] - 2 * pts[2] + pts[3];
+    GVector E = {std::max(std::abs(E0.x), std::abs(E1.x)),
+                 std::max(std::abs(E0.y), std::abs(E1.y))};
+    auto n = GCeilToInt(std::sqrt(3 * E.length() / (4 * fTolerance)));
+    n = std::max(n, GCeilToInt(polygonTurn(pts, 4) / fMaxTurn));
+    n = std::min(kMaxCurveSegments, std::max(1, n));
+    for (auto i = 1; i < n; i++) {
+        auto t = static_cast<float>(i) / n;
+        lineTo(A + t * (c + t * (b + t * a)), true);
+    }
+    lineTo(pts[3], false);
+}
+
+void GStroker::finishContour() {
+    if (fStroke.closed && fContour.size() > 2 && fContour.front() != fContour.back()) {
+        //* the segment back to the start that filling the contour implies
+        fContour.push_back(fContour.front());
+        fSmooth.push_back(false);
+    }
+    auto n = static_cast<int>(fContour.size());
+    const auto& p = fContour;
+    if (n == 1) {
+        //* a lone point only shows its caps
+        if (fStroke.cap == GStrokeCap::kRound) {
+            addCircle(p[0]);
+        } else if (fStroke.cap == GStrokeCap::kSquare) {
+            auto r = fRadius;
+            const GPoint square[] = {p[0] + GVector{-r, -r}, p[0] + GVector{r, -r},
+                                     p[0] + GVector{r, r}, p[0] + GVector{-r, r}};
+            addPiece(square, 4);
+        }
+    } else if (n > 1) {
+        for (auto i = 0; i + 1 < n; i++) {
+            auto u = normalize(p[i + 1] - p[i]);
+            GVector offset = {-u.y * fRadius, u.x * fRadius};
+            const GPoint quad[] = {p[i] + offset, p[i + 1] + offset, p[i + 1] - offset,
+                                   p[i] - offset};
+            addPiece(quad, 4);
+        }
+        for (auto i = 1; i + 1 < n; i++) {
+            addJoin(p[i], p[i] - p[i - 1], p[i + 1] - p[i],
+                    fSmooth[i] ? GStrokeJoin::kBevel : fStroke.join);
+        }
+        if (n > 2 && p[0] == p[n - 1]) {
+            addJoin(p[0], p[0] - p[n - 2], p[1] - p[0], fStroke.join);
+        } else {
+            addCap(p[0], p[0] - p[1]);
+            addCap(p[n - 1], p[n - 1] - p[n - 2]);
+        }
+    }
+    fContour.clear();
+    fSmooth.clear();
+}
+
+void GStroker::addJoin(GPoint p, GVector before, GVector after, GStrokeJoin join) {
+    auto u0 = normalize(before);
+    auto u1 = normalize(after);
+    auto c = cross(u0, u1);
+    auto d = dot(u0, u1);
+    if (c == 0 && d > 0) {
+        return;
+    }
+    if (join == GStrokeJoin::kRound) {
+        addCircle(p);
+        return;
+    }
+
+    //* the outer side of the corner is the one the direction turns away from
+    auto side = c > 0 ? -fRadius : fRadius;
+    GVector n0 = {-u0.y * side, u0.x * side};
+    GVector n1 = {-u1.y * side, u1.x * side};
+    if (join == GStrokeJoin::kMiter && d > -1) {
+        // the miter tip is 1 / cos(angle / 2) = sqrt(2 / (1 + d)) half-widths from p
+        if (2 <= fStroke.miterLimit * fStroke.miterLimit * (1 + d)) {
+            const GPoint miter[] = {p, p + n0, p + (n0 + n1) * (1 / (1 + d)), p + n1};
+            addPiece(miter, 4);
+            return;
+        }
+    }
+    const GPoint bevel[] = {p, p + n0, p + n1};
+    addPiece(bevel, 3);
+}
+
+void GStroker::addCap(GPoint p, GVector outward) {
+    switch (fStroke.cap) {
+    case GStrokeCap::kButt:
+        break;
+    case GStrokeCap::kRound:
+        addCircle(p);
+        break;
+    case GStrokeCap::kSquare: {
+        auto u = normalize(outward) * fRadius;
+        GVector offset = {-u.y, u.x};
+        const GPoint square[] = {p + offset, p + offset + u, p - offset + u, p - offset};
+        addPiece(square, 4);
+        break;
+    }
+    }
+}
+
+void GStroker::addCircle(GPoint center) {
+    GPoint pts[256];
+    for (auto i = 0; i < fCircleSegments; i++) {
+        auto angle = 2 * gFloatPI * i / fCircleSegments;
+        pts[i] = center + GVector{std::cos(angle), std::sin(angle)} * fRadius;
+    }
+    addPiece(pts, fCircleSegments);
+}
+
+void GStroker::addPiece(const GPoint pts[], int count) {
+    float area = 0;
+    for (auto i = 2; i < count; i++) {
+        area += cross(pts[i - 1] - pts[0], pts[i] - pts[0]);
+    }
+    if (area == 0) {
+        return;
+    }
+    if (area > 0) {
+        fPieces.insert(fPieces.end(), pts, pts + count);
+    } else {
+        fPieces.insert(fPieces.end(), std::reverse_iterator<const GPoint*>(pts + count),
+                       std::reverse_iterator<const GPoint*>(pts));
+    }
+    fCounts.push_back(count);
+}
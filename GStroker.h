@@ -0,0 +1,70 @@
+#ifndef GStroker_DEFINED
+#define GStroker_DEFINED
+
+#include "include/GPath.h"
+#include "include/GPathBuilder.h"
+#include "include/GPoint.h"
+#include <vector>
+
+/**
+ *  Turns paths into the convex pieces of their stroked outline.
+ *
+ *  Every segment becomes a quad, every corner a triangle (bevel), quad (miter) or circle (round),
+ *  and every open end a cap. The pieces overlap, but all wind the same way, so their union is
+ *  the stroke under non-zero winding, and any blend that is idempotent (e.g. an opaque color)
+ *  can draw them one at a time. Curves are cut into at most kMaxCurveSegments lines, enough to
+ *  keep both the curve and its offsets within tolerance; the corners between those lines are
+ *  beveled.
+ */
+class GStroker {
+public:
+    static constexpr int kMaxCurveSegments = 64;
+
+    GStroker(const GStroke&, float tolerance);
+
+    // Append the pieces of stroking each contour of the path.
+    void addPath(const GPath&);
+
+    // Call piece(pts, count) for each convex piece, in the order they were added.
+    template <typename Piece> void forEachPiece(Piece&& piece) const {
+        const GPoint* pts = fPieces.data();
+        for (auto count : fCounts) {
+            piece(pts, count);
+            pts += count;
+        }
+    }
+
+    // Discard the pieces, keeping their storage for the next addPath().
+    void reset() {
+        fPieces.clear();
+        fCounts.clear();
+    }
+
+private:
+    GStroke fStroke;
+    float fRadius;
+    float fTolerance;
+    // lines per full turn for round joins and caps, and the most a curve may turn per line
+    int fCircleSegments;
+    float fMaxTurn;
+
+    // the contour being stroked, without repeated points; smooth points are within a curve
+    std::vector<GPoint> fContour;
+    std::vector<bool> fSmooth;
+
+    std::vector<GPoint> fPieces;
+    std::vector<int> fCounts;
+
+    void lineTo(GPoint, bool smooth);
+    void quadTo(const GPoint pts[3]);
+    void cubicTo(const GPoint pts[4]);
+    void finishContour();
+
+    void addJoin(GPoint p, GVector before, GVector after, GStrokeJoin);
+    void addCap(GPoint p, GVector outward);
+    void addCircle(GPoint center);
+    // append the convex polygon, reversing it if needed so every piece winds the same way
+    void addPiece(const GPoint pts[], int count);
+};
+
+#endif
@@ -3,6 +3,10 @@
  */
 
 #include "MyCanvas.h"
+#include "GAreaRasterizer.h"
+#include "GStaticPath.h"
+#include "GStripRasterizer.h"
+#include "GStroker.h"
 #include "include/GBitmap.h"
 #include "include/GColor.h"
 #include "include/GMath.h"
@@ -15,6 +19,7 @@
 #include "include/GShader.h"
 #include "utils.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
@@ -31,14 +36,32 @@ void MyCanvas::clear(const GColor& color) {
     }
 }
 
-void MyCanvas::drawRect(const GRect& rect, const GPaint& paint) {
-    auto roundedRect = rect.round();
-    auto l = std::max(0, roundedRect.left);
-    auto r = std::min(fDevice.width(), roundedRect.right);
+// the device pixels a rect covers under a scale+translate matrix (those whose centers it contains),
+// clipped to the device; drawRect and drawRects both go through this, so they agree
+static GIRect device_rect(const GRect& rect, const GMatrix& m, const GBitmap& device) {
+    auto x0 = rect.left * m[0] + m[4], x1 = rect.right * m[0] + m[4];
+    auto y0 = rect.top * m[3] + m[5], y1 = rect.bottom * m[3] + m[5];
+    return GIRect::LTRB(std::max(0, GRoundToInt(std::min(x0, x1))),
+                        std::max(0, GRoundToInt(std::min(y0, y1))),
+                        std::min(device.width(), GRoundToInt(std::max(x0, x1))),
+                        std::min(device.height(), GRoundToInt(std::max(y0, y1))));
+}
 
-    if (l >= r)
+void MyCanvas::drawRect(const GRect& rect, const GPaint& paint) {
+    if (paint.isAntiAlias()) {
+        GPoint pts[] = {{rect.left, rect.top},
+                        {rect.right, rect.top},
+                        {rect.right, rect.bottom},
+                        {rect.left, rect.bottom}};
+        drawConvexPolygon(pts, 4, paint);
         return;
-    if (paint.peekShader() || ctm != GMatrix()) {
+    }
+    if (fCtmType & GMatrix::kAffine_Mask) {
+        auto roundedRect = rect.round();
+        auto l = std::max(0, roundedRect.left);
+        auto r = std::min(fDevice.width(), roundedRect.right);
+        if (l >= r)
+            return;
         auto points =
             std::vector<GPoint>{{static_cast<float>(l), static_cast<float>(roundedRect.top)},
                                 {static_cast<float>(r), static_cast<float>(roundedRect.top)},
@@ -48,13 +71,95 @@ void MyCanvas::drawRect(const GRect& rect, const GPaint& paint) {
         return;
     }
 
-    for (auto h = std::max(0, roundedRect.top); h < std::min(fDevice.height(), roundedRect.bottom);
-         h++) {
-        blend_row(l, h, r - l, paint, fDevice, ctm);
+    //* without rotation or skew the rect stays a rect: map it, then round it to pixels
+    auto device = device_rect(rect, ctm, fDevice);
+    auto l = device.left, t = device.top, r = device.right, b = device.bottom;
+    if (l >= r || t >= b)
+        return;
+
+    auto shader = paint.peekShader();
+    if (shader) {
+        shader->setContext(ctm);
+    }
+    if (shader && shader->isColumnConstant() && !shader->asConstantColor() &&
+        !shader->isRowConstant()) {
+        //* every row is the same, so only shade the first one
+        auto mode = paint.getBlendMode();
+        if (shader->isOpaque()) {
+            mode = reduce_mode_opaque(mode);
+        }
+        GPixel pixelsToFill[r - l];
+        shader->shadeRow(l, t, r - l, pixelsToFill);
+        for (auto h = t; h < b; h++) {
+            blend_pixels_row(fDevice.getAddr(l, h), r - l, pixelsToFill, mode);
+        }
+    } else {
+        for (auto h = t; h < b; h++) {
+            blend_row(l, h, r - l, paint, fDevice, ctm);
+        }
+    }
+    // setContext() concatenated the ctm's inverse (a no-op for the identity), so undo it
+    if (shader && fCtmType != GMatrix::kIdentity_Mask) {
+        const auto& inv = ctmInverse();
+        if (inv.has_value()) {
+            shader->setContext(*inv);
+        }
+    }
+}
+
+void MyCanvas::drawRects(const GRect rects[], int count, const GPaint& paint) {
+    fillRects(rects, nullptr, count, paint);
+}
+
+void MyCanvas::drawRects(const GRect rects[], const GColor colors[], int count,
+                         const GPaint& paint) {
+    fillRects(rects, colors, count, paint);
+}
+
+void MyCanvas::fillRects(const GRect rects[], const GColor colors[], int count,
+                         const GPaint& paint) {
+    if (paint.peekShader() || paint.isAntiAlias() || (fCtmType & GMatrix::kAffine_Mask)) {
+        GPaint p(paint);
+        for (auto i = 0; i < count; i++) {
+            drawRect(rects[i], colors ? p.setColor(colors[i]) : paint);
+        }
+        return;
+    }
+
+    //* one pass over all the rects: map by the scale+translate ctm, round and clip
+    std::vector<GIRect> device(count);
+    for (auto i = 0; i < count; i++) {
+        device[i] = device_rect(rects[i], ctm, fDevice);
+    }
+
+    auto mode = paint.getBlendMode();
+    auto pixel = colorToPixel(paint.getColor());
+    std::vector<GPixel> pixels;
+    if (colors) {
+        pixels.resize(count);
+        for (auto i = 0; i < count; i++) {
+            pixels[i] = colorToPixel(colors[i]);
+        }
+    }
+
+    for (auto i = 0; i < count; i++) {
+        const auto& d = device[i];
+        if (d.left >= d.right || d.top >= d.bottom)
+            continue;
+        auto src = colors ? pixels[i] : pixel;
+        for (auto y = d.top; y < d.bottom; y++) {
+            blend_color_row(fDevice.getAddr(d.left, y), d.right - d.left, src, mode);
+        }
     }
 }
 
 void MyCanvas::drawConvexPolygon(const GPoint points[], int count, const GPaint& paint) {
+    if (paint.isAntiAlias()) {
+        GPathBuilder bu;
+        bu.addPolygon(points, count);
+        drawPath(*bu.detach(), paint);
+        return;
+    }
 
     if (paint.peekShader()) {
 
@@ -62,20 +167,20 @@ void MyCanvas::drawConvexPolygon(const GPoint points[], int count, const GPaint&
     }
     GPoint newPoints[count];
     auto edges = std::vector<GEdge>();
-    if (ctm != GMatrix()) {
+    if (fCtmType != GMatrix::kIdentity_Mask) {
         ctm.mapPoints(newPoints, points, count);
 
         for (auto i = 0; i < count; i += 1) {
-            auto edge = createEdge(newPoints[i], newPoints[i + 1 == count ? 0 : i + 1]);
-            if (!edge.horizontal()) {
-                clipEdgeTo(edges, fDevice, edge);
+            auto next = newPoints[i + 1 == count ? 0 : i + 1];
+            if (!isHorizontalEdge(newPoints[i], next)) {
+                clipEdgeTo(edges, fDevice, createEdge(newPoints[i], next));
             }
         }
     } else {
         for (auto i = 0; i < count; i += 1) {
-            auto edge = createEdge(points[i], points[i + 1 == count ? 0 : i + 1]);
-            if (!edge.horizontal()) {
-                clipEdgeTo(edges, fDevice, edge);
+            auto next = points[i + 1 == count ? 0 : i + 1];
+            if (!isHorizontalEdge(points[i], next)) {
+                clipEdgeTo(edges, fDevice, createEdge(points[i], next));
             }
         }
     }
@@ -96,10 +201,10 @@ void MyCanvas::drawConvexPolygon(const GPoint points[], int count, const GPaint&
         if (j < edges.size() && r >= edges[j].bottom.y) {
             j = nextIdx++;
         }
-        if (r < edges[i].top.y || r < edges[j].top.y)
-            continue;
         if (i >= edges.size() || j >= edges.size())
             break;
+        if (r < edges[i].top.y || r < edges[j].top.y)
+            continue;
         auto left = GRoundToInt(std::min(edges[i].getX(r), edges[j].getX(r)));
         // auto left = GFloorToInt(std::min(edges[i].getX(r), edges[j].getX(r)));
         auto right = GRoundToInt(std::max(edges[i].getX(r), edges[j].getX(r)));
@@ -107,9 +212,9 @@ void MyCanvas::drawConvexPolygon(const GPoint points[], int count, const GPaint&
         blend_row(left, GFloorToInt(r), right - left, paint, fDevice, ctm);
     }
     if (paint.peekShader()) {
-        auto inv = ctm.invert();
+        const auto& inv = ctmInverse();
         if (inv.has_value()) {
-            paint.peekShader()->setContext(*ctm.invert());
+            paint.peekShader()->setContext(*inv);
         }
     }
 }
@@ -120,71 +225,85 @@ void MyCanvas::restore() {
     assert(!copies.empty());
     ctm = GMatrix(copies.back());
     copies.pop_back();
+    ctmChanged();
 }
 
-void MyCanvas::concat(const GMatrix& matrix) { ctm = ctm * matrix; }
+void MyCanvas::concat(const GMatrix& matrix) {
+    ctm = ctm * matrix;
+    ctmChanged();
+}
+
+void MyCanvas::ctmChanged() {
+    fCtmType = ctm.getType();
+    fCtmInverseDirty = true;
+}
+
+const nonstd::optional<GMatrix>& MyCanvas::ctmInverse() {
+    if (fCtmInverseDirty) {
+        fCtmInverse = ctm.invert();
+        fCtmInverseDirty = false;
+    }
+    return fCtmInverse;
+}
 
 void createQuadEdgesTo(std::vector<GEdge>& edges, const GPoint src[3], int numToChop,
-                       const GBitmap fDevice) {
+                       GISize clip) {
     if (numToChop == 0) {
-        auto edge = createEdge(src[0], src[2]);
-        if (!edge.horizontal()) {
-            clipEdgeTo(edges, fDevice, edge);
+        if (!isHorizontalEdge(src[0], src[2])) {
+            clipEdgeTo(edges, clip, createEdge(src[0], src[2]));
         }
         return;
     }
     GPoint dst[5];
     GPath::ChopQuadAt(src, dst, 0.5);
-    createQuadEdgesTo(edges, dst, numToChop - 1, fDevice);
-    createQuadEdgesTo(edges, dst + 2, numToChop - 1, fDevice);
+    createQuadEdgesTo(edges, dst, numToChop - 1, clip);
+    createQuadEdgesTo(edges, dst + 2, numToChop - 1, clip);
 }
 
 void createCubicEdgesTo(std::vector<GEdge>& edges, const GPoint src[4], int numToChop,
-                        const GBitmap fDevice) {
+                        GISize clip) {
     if (numToChop == 0) {
-        auto edge = createEdge(src[0], src[3]);
-        if (!edge.horizontal()) {
-            clipEdgeTo(edges, fDevice, edge);
+        if (!isHorizontalEdge(src[0], src[3])) {
+            clipEdgeTo(edges, clip, createEdge(src[0], src[3]));
         }
         return;
     }
     GPoint dst[7];
     GPath::ChopCubicAt(src, dst, 0.5);
-    createCubicEdgesTo(edges, dst, numToChop - 1, fDevice);
-    createCubicEdgesTo(edges, dst + 3, numToChop - 1, fDevice);
+    createCubicEdgesTo(edges, dst, numToChop - 1, clip);
+    createCubicEdgesTo(edges, dst + 3, numToChop - 1, clip);
 }
 
-void MyCanvas::drawPath(const GPath& path, const GPaint& paint) {
-
-    if (paint.peekShader()) {
-        paint.peekShader()->setContext(ctm);
-    }
-    auto transformedPath = path.transform(ctm);
-    GPath::Edger edger(*transformedPath);
+// Flatten the path, mapped by matrix, into edges clipped to [0, clip.width) x [0, clip.height),
+// appending them to edges.
+void createPathEdgesTo(std::vector<GEdge>& edges, const GPath& path, const GMatrix& matrix,
+                       GISize clip) {
+    GPath::Edger edger(path);
     GPoint pts[GPath::kMaxNextPoints];
-    auto edges = std::vector<GEdge>();
     while (auto v = edger.next(pts)) {
         switch (v.value()) {
         case GPathVerb::kLine: {
-            auto edge = createEdge(pts[0], pts[1]);
-            if (!edge.horizontal()) {
-                clipEdgeTo(edges, fDevice, edge);
+            matrix.mapPoints(pts, 2);
+            if (!isHorizontalEdge(pts[0], pts[1])) {
+                clipEdgeTo(edges, clip, createEdge(pts[0], pts[1]));
             }
             break;
         }
         case GPathVerb::kQuad: {
+            matrix.mapPoints(pts, 3);
             auto A = pts[0];
             auto B = pts[1];
             auto C = pts[2];
             auto E = A - 2 * B + C;
             auto err = std::abs(E.length() / 4);
 
-            int numSegs = GCeilToInt(std::sqrt(err * 4));
+            int numSegs = std::max(1, GCeilToInt(std::sqrt(err * 4)));
             int numToChop = GCeilToInt(std::log2(numSegs));
-            createQuadEdgesTo(edges, pts, numToChop, fDevice);
+            createQuadEdgesTo(edges, pts, numToChop, clip);
             break;
         }
         case GPathVerb::kCubic: {
+            matrix.mapPoints(pts, 4);
             auto A = pts[0];
             auto B = pts[1];
             auto C = pts[2];
@@ -193,79 +312,916 @@ void MyCanvas::drawPath(const GPath& path, const GPaint& paint) {
             auto E1 = B - 2 * C + D;
             GPoint E = {std::max(E0.x, E1.x), std::max(E0.y, E1.y)};
             auto err = std::abs(E.length());
-            int numSegs = GCeilToInt(std::sqrt(3 * err));
+            int numSegs = std::max(1, GCeilToInt(std::sqrt(3 * err)));
             int numToChop = GCeilToInt(std::log2(numSegs));
-            createCubicEdgesTo(edges, pts, numToChop, fDevice);
+            createCubicEdgesTo(edges, pts, numToChop, clip);
         }
         default:
             break;
         }
     }
-    if (edges.size() < 2)
-        return;
-    // std::cout << edges.size() << std::endl;
-    // for (int i = 0; i < edges.size(); i++) {
-    //     if (edges[i].horizontal()) {
-    //         edges.erase(edges.begin() + i);
-    //         i--;
-    //     }
-    // }
-
-    std::sort(edges.begin(), edges.end(), [](GEdge a, GEdge b) {
-        if (GRoundToInt(a.top.y) == GRoundToInt(b.top.y)) {
-            return a.getX(a.top.y + 0.5) < b.getX(b.top.y + 0.5);
-        }
-        return GRoundToInt(a.top.y) < GRoundToInt(b.top.y);
-    });
+}
 
-    // TODO: Handle quadratic and cubic curves in the path
+/**
+ *  Sweeps the edges [begin, end) of one path top to bottom using non-zero winding, one scanline
+ *  per step(), so the caller can act between scanlines (e.g. flush a row's spans). The edges are
+ *  reordered (and the finished ones dropped) in place.
+ */
+class EdgeWalker {
+public:
+    EdgeWalker(GEdge* begin, GEdge* end, int clipWidth)
+        : fEdges(begin), fCount(end - begin), fClipWidth(clipWidth) {
+        if (fCount < 2)
+            return;
+
+        std::sort(fEdges, fEdges + fCount, [](GEdge a, GEdge b) {
+            if (GRoundToInt(a.top.y) == GRoundToInt(b.top.y)) {
+                return a.getX(a.top.y + 0.5f) < b.getX(b.top.y + 0.5f);
+            }
+            return GRoundToInt(a.top.y) < GRoundToInt(b.top.y);
+        });
 
-    auto yUpper = GRoundToInt(edges[0].top.y) + 0.5;
-    float yLower = 0;
-    for (auto edge : edges) {
-        yLower = std::max(yLower, edge.bottom.y);
+        fY = GRoundToInt(fEdges[0].top.y) + 0.5f;
+        float yLower = 0;
+        for (size_t i = 0; i < fCount; i++) {
+            yLower = std::max(yLower, fEdges[i].bottom.y);
+        }
+        fYLower = GRoundToInt(yLower) + 0.5f;
     }
-    yLower = GRoundToInt(yLower) + 0.5;
 
-    for (auto y = yUpper; y < yLower; ++y) {
+    bool done() const { return fY >= fYLower; }
+
+    // Call blit(y, L, R) for every span of the current scanline, where y is its center and
+    // [L, R) are pixel columns inside [0, clipWidth), then move to the next scanline.
+    // (The centers, e.g. 3.5, are exact in float for any device size.)
+    template <typename Blit> void step(Blit&& blit) {
+        auto y = fY;
         size_t i = 0;
         int w = 0;
         int L;
 
-        while (i < edges.size() && edges[i].valid(y)) {
-            int x = GFloorToInt(edges[i].getX(y));
+        while (i < fCount && fEdges[i].valid(y)) {
+            int x = GFloorToInt(fEdges[i].getX(y));
             if (x < 0) {
                 x = 0;
             }
-            if (x >= fDevice.width()) {
-                x = fDevice.width() - 1;
+            if (x >= fClipWidth) {
+                x = fClipWidth - 1;
             }
             if (w == 0) {
                 L = x;
             }
-            w += edges[i].winding;
+            w += fEdges[i].winding;
             if (w == 0) {
-                blend_row(L, GRoundToInt(y), x - L, paint, fDevice, ctm);
+                blit(y, L, x);
             }
 
-            if (edges[i].valid(y + 1)) {
+            if (fEdges[i].valid(y + 1)) {
                 ++i;
             } else {
-                edges.erase(edges.begin() + i);
+                std::move(fEdges + i + 1, fEdges + fCount, fEdges + i);
+                fCount--;
             }
         }
-        // assert(w == 0);
 
-        while (i < edges.size() && edges[i].valid(y + 1)) {
+        while (i < fCount && fEdges[i].valid(y + 1)) {
             ++i;
         }
-        std::sort(edges.begin(), edges.begin() + i,
-                  [y](auto a, auto b) { return a.getX(y + 1) < b.getX(y + 1); });
+        //* the order only changes where edges cross, so an insertion sort is close to linear
+        for (size_t k = 1; k < i; k++) {
+            auto edge = fEdges[k];
+            auto x = edge.getX(y + 1);
+            auto j = k;
+            for (; j > 0 && x < fEdges[j - 1].getX(y + 1); j--) {
+                fEdges[j] = fEdges[j - 1];
+            }
+            fEdges[j] = edge;
+        }
+        fY++;
+    }
+
+private:
+    GEdge* fEdges;
+    size_t fCount;
+    int fClipWidth;
+    float fY = 0;
+    float fYLower = 0;
+};
+
+/**
+ *  Sweep the edges top to bottom using non-zero winding, calling blit(y, L, R) for every span,
+ *  where y is the center of the scanline and [L, R) are pixel columns inside [0, clipWidth).
+ */
+template <typename Blit> void walkEdges(std::vector<GEdge>& edges, int clipWidth, Blit&& blit) {
+    EdgeWalker walker(edges.data(), edges.data() + edges.size(), clipWidth);
+    while (!walker.done()) {
+        walker.step(blit);
+    }
+}
+
+/**
+ *  Collects the spans of one row before blitting them, merging the ones that touch (e.g. from
+ *  adjacent contours), so each merged span costs one blit. The paint's pixel and mode are
+ *  looked up once per paint rather than once per span.
+ */
+class SpanBlitter {
+public:
+    SpanBlitter(const GBitmap& device, const GMatrix& ctm) : fDevice(device), fCtm(ctm) {}
+
+    void setPaint(const GPaint& paint) {
+        fPaint = &paint;
+        fPixel = colorToPixel(paint.getColor());
+        fMode = paint.getBlendMode();
+    }
+
+    // Add the span [L, R) of row y, where spans arrive left to right.
+    void add(int y, int L, int R) {
+        if (L >= R)
+            return;
+        fY = y;
+        if (!fSpans.empty() && L <= fSpans.back().second) {
+            fSpans.back().second = std::max(fSpans.back().second, R);
+        } else {
+            fSpans.push_back({L, R});
+        }
+    }
+
+    // Blit the spans collected for the current row.
+    void flush() {
+        if (fPaint->peekShader()) {
+            for (auto span : fSpans) {
+                blend_row(span.first, fY, span.second - span.first, *fPaint, fDevice, fCtm);
+            }
+        } else {
+            for (auto span : fSpans) {
+                blend_color_row(fDevice.getAddr(span.first, fY), span.second - span.first, fPixel,
+                                fMode);
+            }
+        }
+        fSpans.clear();
+    }
+
+private:
+    const GBitmap& fDevice;
+    const GMatrix& fCtm;
+    const GPaint* fPaint = nullptr;
+    GPixel fPixel;
+    GBlendMode fMode;
+
+    int fY = 0;
+    std::vector<std::pair<int, int>> fSpans;
+};
+
+/**
+ *  Sweep the edges with EdgeWalker, blitting each row's spans through the blitter.
+ */
+void blitEdges(std::vector<GEdge>& edges, int clipWidth, SpanBlitter& blitter) {
+    EdgeWalker walker(edges.data(), edges.data() + edges.size(), clipWidth);
+    while (!walker.done()) {
+        walker.step([&](float y, int L, int R) { blitter.add(GRoundToInt(y), L, R); });
+        blitter.flush();
+    }
+}
+
+/**
+ *  Accumulates the spans of kSuperSample sub-scanlines per device row into per-pixel coverage.
+ *  Fully covered pixels go through a difference array, so a span costs O(1) regardless of
+ *  its length; the row is resolved with one prefix sum when it is flushed.
+ */
+class SuperSampler {
+public:
+    static constexpr int kShift = 2;
+    static constexpr int kSuperSample = 1 << kShift;
+    static constexpr int kMask = kSuperSample - 1;
+
+    SuperSampler(const GBitmap& device, const GPaint& paint)
+        : fDevice(device), fPaint(paint), fDelta(device.width() + 2, 0),
+          fCoverage(device.width() + 2, 0) {}
+
+    // Add the sub-scanline span [L, R) (in supersampled columns) of supersampled row superY.
+    void blitSuperH(int superY, int L, int R) {
+        if (L >= R)
+            return;
+        auto y = superY >> kShift;
+        if (y != fY) {
+            flush();
+            fY = y;
+        }
+        auto pl = L >> kShift;
+        auto pr = R >> kShift;
+        if (pl == pr) {
+            fDelta[pl] += R - L;
+            fDelta[pl + 1] -= R - L;
+        } else {
+            fDelta[pl] += kSuperSample - (L & kMask);
+            fDelta[pl + 1] += L & kMask;
+            fDelta[pr] += (R & kMask) - kSuperSample;
+            fDelta[pr + 1] -= R & kMask;
+        }
+        fMinX = std::min(fMinX, pl);
+        fMaxX = std::max(fMaxX, pr + 1);
+    }
+
+    void flush() {
+        if (fY < 0 || fMinX >= fMaxX)
+            return;
+        auto right = std::min(fMaxX, fDevice.width());
+        int sum = 0;
+        for (auto x = fMinX; x < fMaxX; x++) {
+            sum += fDelta[x];
+            fDelta[x] = 0;
+            if (x < right) {
+                // kSuperSample^2 samples per pixel, scaled to [0, 255]
+                fCoverage[x] = std::min(255, sum * 255 >> (2 * kShift));
+            }
+        }
+        fDelta[fMaxX] = 0;
+        if (fMinX < right) {
+            blend_anti_row(fMinX, fY, right - fMinX, &fCoverage[fMinX], fPaint, fDevice);
+        }
+        fMinX = kEmpty;
+        fMaxX = 0;
+    }
+
+private:
+    const GBitmap& fDevice;
+    const GPaint& fPaint;
+    std::vector<int> fDelta;
+    std::vector<uint8_t> fCoverage;
+    static constexpr int kEmpty = 1 << 30;
+
+    int fY = -1;
+    int fMinX = kEmpty;
+    int fMaxX = 0;
+};
+
+// AA paths covering at least this many device pixels use the sparse strip rasterizer
+constexpr int kStripRasterizerMinArea = 256 * 256;
+// smaller AA paths with at least this many points use the area rasterizer instead of supersampling
+constexpr size_t kAreaRasterizerMinPoints = 64;
+
+void MyCanvas::drawAntiAliasPath(const GPath& path, const GPaint& paint, size_t complexity) {
+    auto devicePath = path.transform(ctm);
+    auto bounds = devicePath->bounds().roundOut();
+    auto clip = GIRect::LTRB(std::max(0, bounds.left), std::max(0, bounds.top),
+                             std::min(fDevice.width(), bounds.right),
+                             std::min(fDevice.height(), bounds.bottom));
+    if (clip.isEmpty())
+        return;
+
+    if (clip.width() * clip.height() >= kStripRasterizerMinArea) {
+        //* large paths: only tiles touched by edges compute coverage, interiors are solid spans
+        GStripRasterizer rasterizer({fDevice.width(), fDevice.height()});
+        rasterizer.addPath(*devicePath);
+        rasterizer.blit(paint, fDevice);
+    } else if (complexity >= kAreaRasterizerMinPoints) {
+        //* complex paths: exact area coverage, cost scales with edges rather than scanlines
+        GAreaRasterizer rasterizer(clip);
+        rasterizer.addPath(*devicePath);
+        rasterizer.blit(paint, fDevice);
+    } else {
+        //* rasterize at kSuperSample x kSuperSample resolution, blit once per device row
+        constexpr int S = SuperSampler::kSuperSample;
+        // one extra column so spans may reach the right edge of the device
+        auto edges = std::vector<GEdge>();
+        createPathEdgesTo(edges, path, GMatrix::Scale(S, S) * ctm,
+                          {fDevice.width() * S + 1, fDevice.height() * S});
+        SuperSampler sampler(fDevice, paint);
+        walkEdges(edges, fDevice.width() * S + 1,
+                  [&](float y, int L, int R) { sampler.blitSuperH(GFloorToInt(y), L, R); });
+        sampler.flush();
+    }
+}
+
+// the most the matrix stretches a unit vector by
+static float max_scale(const GMatrix& m) {
+    return std::max(std::hypot(m[0], m[1]), std::hypot(m[2], m[3]));
+}
+
+// paths with at least this many points, drawn at most this scale, may be drawn from a level of
+// detail (see GPath::levelOfDetail) within this many pixels of them
+constexpr size_t kLODMinPoints = 32;
+constexpr float kLODMaxScale = 0.5f;
+constexpr float kLODDeviceTolerance = 0.25f;
+
+const GPath& MyCanvas::levelOfDetail(const GPath& path) {
+    auto scale = max_scale(ctm);
+    if (path.countPoints() < kLODMinPoints || !(scale > 0) || scale > kLODMaxScale) {
+        return path;
+    }
+    return path.levelOfDetail(kLODDeviceTolerance / scale);
+}
+
+void MyCanvas::drawPath(const GPath& original, const GPaint& paint) {
+    GRect oval;
+    if (!paint.isAntiAlias() && original.isOval(&oval) && fillOval(oval, paint)) {
+        return;
+    }
+    //* zoomed out, the path's detail that is below a pixel can be left out
+    const auto& path = levelOfDetail(original);
+
+    if (paint.peekShader()) {
+        paint.peekShader()->setContext(ctm);
+    }
+    if (paint.isAntiAlias()) {
+        drawAntiAliasPath(path, paint, original.countPoints());
+    } else {
+        auto edges = std::vector<GEdge>();
+        createPathEdgesTo(edges, path, ctm, {fDevice.width(), fDevice.height()});
+        SpanBlitter blitter(fDevice, ctm);
+        blitter.setPaint(paint);
+        blitEdges(edges, fDevice.width(), blitter);
     }
     if (paint.peekShader()) {
-        auto inv = ctm.invert();
+        const auto& inv = ctmInverse();
+        if (inv.has_value()) {
+            paint.peekShader()->setContext(*inv);
+        }
+    }
+}
+
+void MyCanvas::strokePath(const GPath& path, const GStroke& stroke, const GPaint& paint) {
+    //* approximate curves and round joins to within a quarter of a device pixel
+    auto scale = max_scale(ctm);
+    GStroker stroker(stroke, scale > 0 ? 0.25f / scale : 0.25f);
+    stroker.addPath(path);
+
+    //* an opaque color lands the same however many pieces cover a pixel, so each convex piece
+    //* can go straight to the convex walker instead of sweeping them all as one path
+    auto mode = reduce_mode_opaque(paint.getBlendMode());
+    if (!paint.isAntiAlias() && !paint.peekShader() && paint.getAlpha() >= 1 &&
+        (mode == GBlendMode::kSrc || mode == GBlendMode::kClear || mode == GBlendMode::kDst)) {
+        stroker.forEachPiece(
+            [&](const GPoint pts[], int count) { drawConvexPolygon(pts, count, paint); });
+        return;
+    }
+    GPathBuilder bu;
+    stroker.forEachPiece([&](const GPoint pts[], int count) { bu.addPolygon(pts, count); });
+    drawPath(*bu.detach(), paint);
+}
+
+void MyCanvas::drawPaths(const GPath* const paths[], const GPaint paints[], int count) {
+    //* anti-aliased paths, and ovals (which drawPath may scan convert exactly), go through drawPath
+    auto batched = [&](int i) { return !paints[i].isAntiAlias() && !paths[i]->isOval(nullptr); };
+    for (auto i = 0; i < count;) {
+        if (!batched(i)) {
+            drawPath(*paths[i], paints[i]);
+            i++;
+            continue;
+        }
+        auto end = i + 1;
+        while (end < count && batched(end)) {
+            end++;
+        }
+        fillPaths(paths + i, paints + i, end - i);
+        i = end;
+    }
+}
+
+void MyCanvas::fillPaths(const GPath* const paths[], const GPaint paints[], int count) {
+    //* a shader shared by several paints must only be put into the ctm's context once
+    std::vector<GShader*> shaders;
+    for (auto i = 0; i < count; i++) {
+        auto shader = paints[i].peekShader();
+        if (shader && std::find(shaders.begin(), shaders.end(), shader) == shaders.end()) {
+            shader->setContext(ctm);
+            shaders.push_back(shader);
+        }
+    }
+
+    //* one edge arena (and span buffer), reused by every path, so their storage stays allocated
+    GISize clip = {fDevice.width(), fDevice.height()};
+    std::vector<GEdge> arena;
+    SpanBlitter blitter(fDevice, ctm);
+    for (auto i = 0; i < count; i++) {
+        arena.clear();
+        createPathEdgesTo(arena, levelOfDetail(*paths[i]), ctm, clip);
+        blitter.setPaint(paints[i]);
+        blitEdges(arena, clip.width, blitter);
+    }
+
+    if (!shaders.empty()) {
+        const auto& inv = ctmInverse();
+        if (inv.has_value()) {
+            for (auto shader : shaders) {
+                shader->setContext(*inv);
+            }
+        }
+    }
+}
+
+/**
+ *  Scan convert the axis-aligned ellipse with the center and radii, calling blit(y, L, R) for the
+ *  pixels [L, R) of each row y whose centers are inside it, clipped to [0, clip.width) x
+ *  [0, clip.height).
+ *
+ *  Like the midpoint algorithm, each row starts from the previous row's span and moves its ends
+ *  a pixel at a time, deciding with the ellipse's implicit equation. Every non-empty row contains
+ *  the column nearest the center, so the spans of consecutive rows overlap. Where the ends move
+ *  quickly (near the top and bottom), a row is seeded from the explicit equation instead.
+ */
+template <typename Blit> void walkOval(GPoint center, double rx, double ry, GISize clip,
+                                       Blit&& blit) {
+    const double cx = center.x;
+    const double cy = center.y;
+    const double rx2 = rx * rx;
+    const double ry2 = ry * ry;
+    constexpr int kMaxSteps = 2;
+
+    auto top = static_cast<int>(std::max(0.0, std::floor(cy - ry)));
+    auto bottom = static_cast<int>(std::min<double>(clip.height, std::ceil(cy + ry)));
+    int L = 0;
+    int R = 0;
+    auto reseed = true;
+    for (auto y = top; y < bottom; y++) {
+        //* a pixel is inside when ry^2 (x - cx)^2 + rx^2 (y - cy)^2 - rx^2 ry^2 <= 0
+        auto dy = y + 0.5 - cy;
+        auto rowTerm = rx2 * (dy * dy - ry2);
+        if (rowTerm > 0) {
+            reseed = true;
+            continue;
+        }
+        auto inside = [&](int x) {
+            auto dx = x + 0.5 - cx;
+            return ry2 * dx * dx + rowTerm <= 0;
+        };
+        if (reseed || L >= R) {
+            auto halfWidth = std::sqrt(-rowTerm / ry2);
+            L = static_cast<int>(std::max(0.0, std::min<double>(clip.width, std::ceil(cx - halfWidth - 0.5))));
+            R = static_cast<int>(std::max(0.0, std::min<double>(clip.width, std::floor(cx + halfWidth + 0.5))));
+        }
+
+        auto steps = 0;
+        for (; R < clip.width && inside(R); R++, steps++) {}
+        for (; R > L && !inside(R - 1); R--, steps++) {}
+        for (; L > 0 && inside(L - 1); L--, steps++) {}
+        for (; L < R && !inside(L); L++, steps++) {}
+        reseed = steps > 2 * kMaxSteps;
+
+        if (L < R) {
+            blit(y, L, R);
+        }
+    }
+}
+
+bool MyCanvas::fillOval(const GRect& rect, const GPaint& paint) {
+    GPoint center = {(rect.left + rect.right) * 0.5f, (rect.top + rect.bottom) * 0.5f};
+    double rx = std::abs(rect.width()) * 0.5;
+    double ry = std::abs(rect.height()) * 0.5;
+
+    if (!(fCtmType & GMatrix::kAffine_Mask)) {
+        //* scale + translate: still an axis-aligned ellipse
+        rx *= std::abs(ctm[0]);
+        ry *= std::abs(ctm[3]);
+    } else {
+        //* rotation (or reflection) + uniform scale only keeps a circle a circle
+        auto tolerance = 1e-6f * (std::abs(ctm[0]) + std::abs(ctm[1]));
+        auto rotation = std::abs(ctm[0] - ctm[3]) <= tolerance &&
+                        std::abs(ctm[1] + ctm[2]) <= tolerance;
+        auto reflection = std::abs(ctm[0] + ctm[3]) <= tolerance &&
+                          std::abs(ctm[1] - ctm[2]) <= tolerance;
+        if (rx != ry || !(rotation || reflection)) {
+            return false;
+        }
+        auto scale = std::sqrt(std::abs(static_cast<double>(ctm[0]) * ctm[3] -
+                                        static_cast<double>(ctm[1]) * ctm[2]));
+        rx *= scale;
+        ry *= scale;
+    }
+    center = ctm * center;
+    if (!(rx > 0 && ry > 0)) {
+        return true;
+    }
+
+    auto shader = paint.peekShader();
+    if (shader) {
+        shader->setContext(ctm);
+    }
+    SpanBlitter blitter(fDevice, ctm);
+    blitter.setPaint(paint);
+    walkOval(center, rx, ry, {fDevice.width(), fDevice.height()}, [&](int y, int L, int R) {
+        blitter.add(y, L, R);
+        blitter.flush();
+    });
+    if (shader) {
+        const auto& inv = ctmInverse();
+        if (inv.has_value()) {
+            shader->setContext(*inv);
+        }
+    }
+    return true;
+}
+
+void MyCanvas::drawOval(const GRect& rect, const GPaint& paint) {
+    if (!paint.isAntiAlias() && fillOval(rect, paint)) {
+        return;
+    }
+    GCanvas::drawOval(rect, paint);
+}
+
+// triangle vertices are snapped to 1/kTriangleOne of a pixel
+constexpr int kTriangleShift = 8;
+constexpr int64_t kTriangleOne = 1 << kTriangleShift;
+// snapped coordinates are clamped to +/- this many pixels, so edge functions fit in 64 bits
+constexpr float kTriangleMaxCoord = 1 << 21;
+
+int64_t floorDiv(int64_t n, int64_t d) { return n >= 0 ? n / d : -((d - 1 - n) / d); }
+
+/**
+ *  Scan the triangle with fixed-point edge functions, calling blit(y, L, R, w, dw) for every
+ *  non-empty span [L, R) of row y inside [0, clip.width) x [0, clip.height). w[k] is the
+ *  barycentric weight of pts[k] at the center of pixel L, and dw[k] is its step per pixel.
+ *
+ *  A pixel center exactly on an edge only belongs to the triangle if it is a top or left edge,
+ *  so triangles sharing an edge never touch the same pixel twice.
+ */
+template <typename Blit> void walkTriangle(const GPoint pts[3], GISize clip, Blit&& blit) {
+    int64_t X[3], Y[3];
+    auto pin = [](float v) {
+        return std::max(-kTriangleMaxCoord, std::min(kTriangleMaxCoord, v));
+    };
+    for (auto k = 0; k < 3; k++) {
+        X[k] = std::llround(pin(pts[k].x) * kTriangleOne);
+        Y[k] = std::llround(pin(pts[k].y) * kTriangleOne);
+    }
+    auto area = (X[1] - X[0]) * (Y[2] - Y[0]) - (Y[1] - Y[0]) * (X[2] - X[0]);
+    if (area == 0)
+        return;
+    //* order the corners so the area is positive, then every edge function is >= 0 inside
+    int v[3] = {0, 1, 2};
+    if (area < 0) {
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+
+    //* edge e is opposite corner v[e], from a = v[e + 1] to b = v[e + 2]:
+    //* E(px, py) = A * (px - ax) + B * (py - ay), which is area at corner v[e]
+    int64_t A[3], B[3], ax[3], ay[3], bias[3];
+    for (auto e = 0; e < 3; e++) {
+        auto a = v[(e + 1) % 3];
+        auto b = v[(e + 2) % 3];
+        A[e] = Y[a] - Y[b];
+        B[e] = X[b] - X[a];
+        ax[e] = X[a];
+        ay[e] = Y[a];
+        auto topLeft = A[e] > 0 || (A[e] == 0 && B[e] > 0);
+        bias[e] = topLeft ? 0 : -1;
+    }
+
+    auto minY = std::min({Y[0], Y[1], Y[2]});
+    auto maxY = std::max({Y[0], Y[1], Y[2]});
+    auto top = static_cast<int>(std::max<int64_t>(0, floorDiv(minY, kTriangleOne)));
+    auto bottom = static_cast<int>(
+        std::min<int64_t>(clip.height, floorDiv(maxY, kTriangleOne) + 1));
+
+    constexpr int64_t kHalf = kTriangleOne / 2;
+    for (auto y = top; y < bottom; y++) {
+        auto py = y * kTriangleOne + kHalf;
+        int64_t L = 0;
+        int64_t R = clip.width;
+        int64_t K[3];
+        for (auto e = 0; e < 3 && L < R; e++) {
+            //* E at the center of pixel x is S * x + K, and the pixel is inside if E + bias >= 0
+            auto S = A[e] * kTriangleOne;
+            K[e] = A[e] * (kHalf - ax[e]) + B[e] * (py - ay[e]);
+            auto k = K[e] + bias[e];
+            if (S > 0) {
+                L = std::max(L, -floorDiv(k, S));
+            } else if (S < 0) {
+                R = std::min(R, floorDiv(k, -S) + 1);
+            } else if (k < 0) {
+                R = L;
+            }
+        }
+        if (L >= R)
+            continue;
+
+        double w[3], dw[3];
+        for (auto e = 0; e < 3; e++) {
+            auto S = A[e] * kTriangleOne;
+            w[v[e]] = static_cast<double>(S * L + K[e]) / area;
+            dw[v[e]] = static_cast<double>(S) / area;
+        }
+        blit(y, static_cast<int>(L), static_cast<int>(R), w, dw);
+    }
+}
+
+void MyCanvas::drawTriangles(const GPoint verts[], const GColor colors[], const int indices[],
+                             int triCount, const GPaint& paint) {
+    if (triCount <= 0)
+        return;
+    auto vertCount = 3 * triCount;
+    if (indices) {
+        vertCount = *std::max_element(indices, indices + 3 * triCount) + 1;
+    }
+
+    //* transform (and premultiply) each vertex once, triangles share them through indices
+    std::vector<GPoint> pts(vertCount);
+    ctm.mapPoints(pts.data(), verts, vertCount);
+    std::vector<std::array<float, 4>> premul;
+    std::vector<GPixel> pixels;
+    if (colors) {
+        premul.resize(vertCount);
+        pixels.resize(vertCount);
+        for (auto i = 0; i < vertCount; i++) {
+            auto c = colors[i].pinToUnit();
+            premul[i] = {c.a * 255, c.r * c.a * 255, c.g * c.a * 255, c.b * c.a * 255};
+            pixels[i] = colorToPixel(c);
+        }
+    }
+
+    auto shader = paint.peekShader();
+    if (shader) {
+        shader->setContext(ctm);
+    }
+    auto mode = paint.getBlendMode();
+    std::vector<GPixel> span(fDevice.width());
+    std::vector<GPixel> shaded(shader && colors ? fDevice.width() : 0);
+    GISize clip = {fDevice.width(), fDevice.height()};
+
+    for (auto i = 0; i < triCount; i++) {
+        int n[3];
+        GPoint tri[3];
+        for (auto k = 0; k < 3; k++) {
+            n[k] = indices ? indices[3 * i + k] : 3 * i + k;
+            tri[k] = pts[n[k]];
+        }
+
+        if (!colors) {
+            walkTriangle(tri, clip, [&](int y, int L, int R, const double*, const double*) {
+                blend_row(L, y, R - L, paint, fDevice, ctm);
+            });
+            continue;
+        }
+        if (!shader && pixels[n[0]] == pixels[n[1]] && pixels[n[0]] == pixels[n[2]]) {
+            //* flat triangle, nothing to interpolate
+            walkTriangle(tri, clip, [&](int y, int L, int R, const double*, const double*) {
+                blend_color_row(fDevice.getAddr(L, y), R - L, pixels[n[0]], mode);
+            });
+            continue;
+        }
+
+        const auto& c0 = premul[n[0]];
+        const auto& c1 = premul[n[1]];
+        const auto& c2 = premul[n[2]];
+        walkTriangle(tri, clip, [&](int y, int L, int R, const double w[3], const double dw[3]) {
+            //* premultiplied A, R, G, B in 16.16, starting at pixel L (+ 0.5 to round)
+            int32_t c[4], dc[4];
+            for (auto k = 0; k < 4; k++) {
+                auto start = w[0] * c0[k] + w[1] * c1[k] + w[2] * c2[k];
+                auto step = dw[0] * c0[k] + dw[1] * c1[k] + dw[2] * c2[k];
+                c[k] = static_cast<int32_t>(std::max(0.0, start + 0.5) * 65536);
+                dc[k] = static_cast<int32_t>(std::lround(step * 65536));
+            }
+            auto count = R - L;
+            for (auto x = 0; x < count; x++) {
+                unsigned a = std::min(255, c[0] >> 16);
+                unsigned r = std::min<unsigned>(a, std::max(0, c[1] >> 16));
+                unsigned g = std::min<unsigned>(a, std::max(0, c[2] >> 16));
+                unsigned b = std::min<unsigned>(a, std::max(0, c[3] >> 16));
+                span[x] = GPixel_PackARGB(a, r, g, b);
+                for (auto k = 0; k < 4; k++) {
+                    c[k] += dc[k];
+                }
+            }
+            if (shader) {
+                shader->shadeRow(L, y, count, shaded.data());
+                for (auto x = 0; x < count; x++) {
+                    auto s = shaded[x];
+                    auto d = span[x];
+                    span[x] = GPixel_PackARGB(div255(GPixel_GetA(s) * GPixel_GetA(d)),
+                                              div255(GPixel_GetR(s) * GPixel_GetR(d)),
+                                              div255(GPixel_GetG(s) * GPixel_GetG(d)),
+                                              div255(GPixel_GetB(s) * GPixel_GetB(d)));
+                }
+            }
+            blend_pixels_row(fDevice.getAddr(L, y), count, span.data(), mode);
+        });
+    }
+
+    if (shader) {
+        const auto& inv = ctmInverse();
+        if (inv.has_value()) {
+            shader->setContext(*inv);
+        }
+    }
+}
+
+enum OutCode {
+    kLeft_OutCode = 1 << 0,
+    kRight_OutCode = 1 << 1,
+    kTop_OutCode = 1 << 2,
+    kBottom_OutCode = 1 << 3,
+};
+
+int outCode(GPoint p, const GRect& r) {
+    return (p.x < r.left ? kLeft_OutCode : p.x > r.right ? kRight_OutCode : 0) |
+           (p.y < r.top ? kTop_OutCode : p.y > r.bottom ? kBottom_OutCode : 0);
+}
+
+/**
+ *  Clip the segment to the rect (Cohen-Sutherland), returning false if none of it is inside.
+ *  Each pass moves one outside end onto the boundary it is beyond, until both ends are inside.
+ */
+bool clipLine(GPoint* p0, GPoint* p1, const GRect& r) {
+    auto c0 = outCode(*p0, r);
+    auto c1 = outCode(*p1, r);
+    while (c0 | c1) {
+        if (c0 & c1) {
+            return false;
+        }
+        auto code = c0 ? c0 : c1;
+        auto a = *p0;
+        auto b = *p1;
+        GPoint p;
+        if (code & (kLeft_OutCode | kRight_OutCode)) {
+            p.x = code & kLeft_OutCode ? r.left : r.right;
+            p.y = a.y + (b.y - a.y) * (p.x - a.x) / (b.x - a.x);
+        } else {
+            p.y = code & kTop_OutCode ? r.top : r.bottom;
+            p.x = a.x + (b.x - a.x) * (p.y - a.y) / (b.y - a.y);
+        }
+        if (code == c0) {
+            *p0 = p;
+            c0 = outCode(p, r);
+        } else {
+            *p1 = p;
+            c1 = outCode(p, r);
+        }
+    }
+    return true;
+}
+
+/**
+ *  Walk the (clipped) device space segment as an aliased hairline with a 16.16 DDA, calling
+ *  blit(y, L, R) for runs of pixels on one row. Along its major axis the segment touches the
+ *  pixels whose centers are in [start, end), so consecutive segments of a polyline do not touch
+ *  their shared pixel twice.
+ */
+template <typename Blit> void walkHairline(GPoint p0, GPoint p1, GISize clip, Blit&& blit) {
+    auto dx = p1.x - p0.x;
+    auto dy = p1.y - p0.y;
+    if (std::abs(dx) >= std::abs(dy)) {
+        if (dx == 0) {
+            return;
+        }
+        if (dx < 0) {
+            std::swap(p0, p1);
+        }
+        auto slope = dy / dx;
+        auto x0 = std::max(0, GCeilToInt(p0.x - 0.5f));
+        auto x1 = std::min(clip.width, GCeilToInt(p1.x - 0.5f));
+        auto fy = static_cast<int32_t>((p0.y + (x0 + 0.5f - p0.x) * slope) * 65536);
+        auto dfy = static_cast<int32_t>(slope * 65536);
+
+        //* consecutive pixels on one row are blitted as one run
+        auto runL = x0;
+        auto runY = fy >> 16;
+        for (auto x = x0; x < x1; x++, fy += dfy) {
+            auto y = fy >> 16;
+            if (y != runY) {
+                if (runY >= 0 && runY < clip.height) {
+                    blit(runY, runL, x);
+                }
+                runL = x;
+                runY = y;
+            }
+        }
+        if (runL < x1 && runY >= 0 && runY < clip.height) {
+            blit(runY, runL, x1);
+        }
+    } else {
+        if (dy < 0) {
+            std::swap(p0, p1);
+        }
+        auto slope = dx / dy;
+        auto y0 = std::max(0, GCeilToInt(p0.y - 0.5f));
+        auto y1 = std::min(clip.height, GCeilToInt(p1.y - 0.5f));
+        auto fx = static_cast<int32_t>((p0.x + (y0 + 0.5f - p0.y) * slope) * 65536);
+        auto dfx = static_cast<int32_t>(slope * 65536);
+        for (auto y = y0; y < y1; y++, fx += dfx) {
+            auto x = fx >> 16;
+            if (x >= 0 && x < clip.width) {
+                blit(y, x, x + 1);
+            }
+        }
+    }
+}
+
+/**
+ *  Walk the (clipped) device space segment as an anti-aliased hairline (Wu's algorithm), calling
+ *  plot(x, y, coverage) for the two pixels straddling the line in each column (or row, for
+ *  steep lines). The pixels at the ends are weighted by how much of them the segment spans.
+ */
+template <typename Plot> void walkHairlineAA(GPoint p0, GPoint p1, Plot&& plot) {
+    auto dx = p1.x - p0.x;
+    auto dy = p1.y - p0.y;
+    auto steep = std::abs(dy) > std::abs(dx);
+    if (steep) {
+        std::swap(p0.x, p0.y);
+        std::swap(p1.x, p1.y);
+        std::swap(dx, dy);
+    }
+    if (dx == 0) {
+        return;
+    }
+    if (dx < 0) {
+        std::swap(p0, p1);
+    }
+    auto slope = dy / dx;
+    auto x0 = GFloorToInt(p0.x);
+    auto x1 = GCeilToInt(p1.x);
+    //* the line's center, less half a pixel, in 16.16: its fraction is the lower pixel's share
+    auto fy = static_cast<int32_t>((p0.y + (x0 + 0.5f - p0.x) * slope - 0.5f) * 65536);
+    auto dfy = static_cast<int32_t>(slope * 65536);
+    for (auto x = x0; x < x1; x++, fy += dfy) {
+        unsigned span = 256;
+        if (x == x0 || x + 1 == x1) {
+            auto w = std::min(x + 1.0f, p1.x) - std::max(static_cast<float>(x), p0.x);
+            span = static_cast<unsigned>(w * 256 + 0.5f);
+        }
+        auto y = fy >> 16;
+        unsigned lower = (fy & 0xFFFF) >> 8;
+        unsigned a = ((255 - lower) * span) >> 8;
+        unsigned b = (lower * span) >> 8;
+        if (steep) {
+            plot(y, x, a);
+            plot(y + 1, x, b);
+        } else {
+            plot(x, y, a);
+            plot(x, y + 1, b);
+        }
+    }
+}
+
+void MyCanvas::drawLines(const GPoint pts[], int count, const GPaint& paint) {
+    if (count < 2)
+        return;
+    std::vector<GPoint> dev(count);
+    ctm.mapPoints(dev.data(), pts, count);
+
+    auto shader = paint.peekShader();
+    if (shader) {
+        shader->setContext(ctm);
+    }
+    GISize clip = {fDevice.width(), fDevice.height()};
+    auto bounds = GRect::WH(clip.width, clip.height);
+
+    if (!paint.isAntiAlias()) {
+        auto pixel = colorToPixel(paint.getColor());
+        auto mode = paint.getBlendMode();
+        auto blit = [&](int y, int L, int R) {
+            if (shader) {
+                blend_row(L, y, R - L, paint, fDevice, ctm);
+            } else {
+                blend_color_row(fDevice.getAddr(L, y), R - L, pixel, mode);
+            }
+        };
+        for (auto i = 0; i + 1 < count; i++) {
+            auto p0 = dev[i];
+            auto p1 = dev[i + 1];
+            if (clipLine(&p0, &p1, bounds)) {
+                walkHairline(p0, p1, clip, blit);
+            }
+        }
+    } else {
+        //* partial pixels just outside the device still cover the pixels along its sides
+        auto aaBounds = GRect::LTRB(-1, -1, clip.width + 1, clip.height + 1);
+        auto src = colorToPixel(paint.getColor());
+        auto mode = paint.getBlendMode();
+        auto modeIdx = static_cast<int>(mode);
+        auto plot = [&](int x, int y, unsigned coverage) {
+            if (coverage == 0 || x < 0 || x >= clip.width || y < 0 || y >= clip.height) {
+                return;
+            }
+            if (shader) {
+                auto cov = static_cast<uint8_t>(coverage);
+                blend_anti_row(x, y, 1, &cov, paint, fDevice);
+                return;
+            }
+            auto dst = fDevice.getAddr(x, y);
+            if (mode == GBlendMode::kSrcOver) {
+                //* lerp(dst, srcover(src, dst), c) == srcover(src * c, dst)
+                blendSrcOver(lerp_pixel(0, src, coverage), dst);
+                return;
+            }
+            auto blended = *dst;
+            blendFuncs[modeIdx](src, &blended);
+            *dst = lerp_pixel(*dst, blended, coverage);
+        };
+        for (auto i = 0; i + 1 < count; i++) {
+            auto p0 = dev[i];
+            auto p1 = dev[i + 1];
+            if (clipLine(&p0, &p1, aaBounds)) {
+                walkHairlineAA(p0, p1, plot);
+            }
+        }
+    }
+
+    if (shader) {
+        const auto& inv = ctmInverse();
         if (inv.has_value()) {
-            paint.peekShader()->setContext(*ctm.invert());
+            shader->setContext(*inv);
         }
     }
 }
@@ -277,18 +1233,19 @@ std::unique_ptr<GCanvas> GCreateCanvas(const GBitmap& device) {
 std::string GDrawSomething(GCanvas* canvas, GISize dim) {
     canvas->translate(-40, 10);
     canvas->scale(3, 3);
-    GPathBuilder bu;
 
-    auto draw = [&](const GPoint pts[], size_t count, const GPaint& paint) {
-        bu.addPolygon(pts, count);
-        canvas->drawPath(*bu.detach(), paint);
-    };
-    GPaint paint({0, 0, 0, 1});
-    const GPoint pts[] = {
-        {41, 94}, {32, 110}, {23, 132}, {12, 163}, {6, 190},  {7, 217},  {5, 236}, {3, 247},
-        {9, 230}, {12, 211}, {12, 185}, {18, 160}, {26, 134}, {35, 110}, {43, 99}, {41, 94},
-    };
-    draw(pts, GARRAY_COUNT(pts), paint);
+    //* the tear is built when compiling, and drawn from a view of its static arrays
+    static constexpr auto kTear = [] {
+        constexpr GPoint pts[] = {
+            {41, 94}, {32, 110}, {23, 132}, {12, 163}, {6, 190},  {7, 217},  {5, 236}, {3, 247},
+            {9, 230}, {12, 211}, {12, 185}, {18, 160}, {26, 134}, {35, 110}, {43, 99}, {41, 94},
+        };
+        GStaticPathBuilder<GARRAY_COUNT(pts)> bu;
+        bu.addPolygon(pts, GARRAY_COUNT(pts));
+        return bu;
+    }();
+    static const auto tear = kTear.view();
+    canvas->drawPath(tear, GPaint({0, 0, 0, 1}));
 
     return "tears in rain";
 }
@@ -19,6 +19,8 @@ public:
 
     void clear(const GColor&) override;
     void drawRect(const GRect&, const GPaint&) override;
+    void drawRects(const GRect[], int count, const GPaint&) override;
+    void drawRects(const GRect[], const GColor[], int count, const GPaint&) override;
     void drawConvexPolygon(const GPoint[], int, const GPaint&) override;
     // void fillRect(const GRect& rect, const GColor& color);
     void save() override;
@@ -26,6 +28,12 @@ public:
     void concat(const GMatrix&) override;
     GMatrix getCtm();
     void drawPath(const GPath&, const GPaint&) override;
+    void strokePath(const GPath&, const GStroke&, const GPaint&) override;
+    void drawPaths(const GPath* const[], const GPaint[], int count) override;
+    void drawOval(const GRect&, const GPaint&) override;
+    void drawLines(const GPoint[], int count, const GPaint&) override;
+    void drawTriangles(const GPoint[], const GColor[], const int indices[], int triCount,
+                       const GPaint&) override;
 
 private:
     // Note: we store a copy of the bitmap
@@ -35,6 +43,31 @@ private:
     GMatrix ctm = GMatrix();
     // GMatrix lastCtm = GMatrix();
     std::vector<GMatrix> copies;
+
+    // ctm's GMatrix::TypeMask, and its inverse (computed the first time it is needed), which
+    // concat() and restore() keep in step with ctm
+    unsigned fCtmType = GMatrix::kIdentity_Mask;
+    nonstd::optional<GMatrix> fCtmInverse = GMatrix();
+    bool fCtmInverseDirty = false;
+
+    void ctmChanged();
+    const nonstd::optional<GMatrix>& ctmInverse();
+
+    // shared by both drawRects, colors may be null
+    void fillRects(const GRect[], const GColor[], int count, const GPaint&);
+
+    // drawPaths for a run of paths without anti-aliasing (and not ovals), sharing one edge arena
+    void fillPaths(const GPath* const[], const GPaint[], int count);
+
+    // scan convert the oval if the ctm keeps it an axis-aligned ellipse, else return false
+    bool fillOval(const GRect&, const GPaint&);
+
+    // the path's level of detail to draw with the ctm, or the path if it is not worth one
+    const GPath& levelOfDetail(const GPath&);
+
+    // drawPath for paints with anti-aliasing, picking a rasterizer for the path's size and the
+    // complexity (point count) of the path it stands for, before any level of detail
+    void drawAntiAliasPath(const GPath&, const GPaint&, size_t complexity);
 };
 
 #endif
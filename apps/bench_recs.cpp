@@ -15,6 +15,7 @@
 #include "bench_pa3.inc"
 #include "bench_pa4.inc"
 #include "bench_pa5.inc"
+#include "bench_pa6.inc"
 
 const GBenchmark::Factory gBenchFactories[] {
     []() -> GBenchmark* { return new ClearBench(); },
@@ -77,5 +78,19 @@ const GBenchmark::Factory gBenchFactories[] {
     []() -> GBenchmark* { return new BitmapBench("apps/spock.png", "bitmap_mirror",
                                                  GTileMode::kMirror); },
 
+    // pa6
+    []() -> GBenchmark* {
+        const GColor colors[] = {{ 1, 0, 0, 1 }, { 0, 1, 1, 1 }, {0, 1, 0, 0}};
+        return new RadialGradientBench(colors, 3, "radial_3");
+    },
+    []() -> GBenchmark* {
+        const GColor colors[] = {{ 1, 0, 0, 1 }, { 0, 1, 1, 1 }};
+        return new RadialGradientBench(colors, 2, "radial_2_repeat", GTileMode::kRepeat);
+    },
+    []() -> GBenchmark* {
+        const GColor colors[] = {{ 1, 0, 0, 1 }, { 0, 1, 1, 1 }, {0, 1, 0, 0}};
+        return new SweepGradientBench(colors, 3, "sweep_3");
+    },
+
     nullptr,
 };
@@ -0,0 +1,121 @@
+#include "image.h"
+#include "../include/GCanvas.h"
+#include "../include/GColor.h"
+#include "../include/GMatrix.h"
+#include "../include/GPath.h"
+#include "../include/GPathBuilder.h"
+#include "../include/GPoint.h"
+#include "../include/GRect.h"
+#include "../include/GShader.h"
+#include <cmath>
+
+// a star with [n] tips, alternating between the two radii, so 2n points
+static std::shared_ptr<GPath> make_star(GPoint center, float outer, float inner, int n) {
+    GPathBuilder bu;
+    for (int i = 0; i < 2 * n; ++i) {
+        auto r = (i & 1) ? inner : outer;
+        auto angle = gFloatPI * i / n;
+        GPoint p = {center.x + r * std::cos(angle), center.y + r * std::sin(angle)};
+        if (i == 0) {
+            bu.moveTo(p);
+        } else {
+            bu.lineTo(p);
+        }
+    }
+    return bu.detach();
+}
+
+static void draw_aa_shape(GCanvas* canvas, const GPath& path, GColor color) {
+    GPaint paint(color);
+    paint.setAntiAlias(true);
+    canvas->drawPath(path, paint);
+}
+
+// small paths with few points: anti-aliased by the supersampler
+static void draw_aa_supersample(GCanvas* canvas) {
+    canvas->clear({1, 1, 1, 1});
+    GPathBuilder bu;
+    for (int i = 0; i < 16; ++i) {
+        auto cx = 32.0f + 64 * (i % 4), cy = 32.0f + 64 * (i / 4);
+        auto angle = i * gFloatPI / 24;
+        canvas->save();
+        canvas->translate(cx, cy);
+        canvas->rotate(angle);
+        switch (i % 4) {
+            case 0:
+                bu.addRect(GRect::LTRB(-20.3f, -12.6f, 19.8f, 13.1f));
+                break;
+            case 1:
+                bu.moveTo(0, -24); bu.lineTo(22, 18); bu.lineTo(-21, 17);
+                break;
+            case 2:
+                bu.addCircle({0, 0}, 22.5f);
+                break;
+            default:
+                bu.moveTo(-22, 0); bu.quadTo(0, -40, 22, 0); bu.quadTo(0, 10, -22, 0);
+                break;
+        }
+        draw_aa_shape(canvas, *bu.detach(), {i / 15.0f, 0.3f, 1 - i / 15.0f, 0.8f});
+        canvas->restore();
+    }
+}
+
+// small paths with 64 or more points: anti-aliased by the area rasterizer
+static void draw_aa_area(GCanvas* canvas) {
+    canvas->clear({1, 1, 1, 1});
+    for (int i = 0; i < 9; ++i) {
+        auto cx = 43.0f + 85 * (i % 3), cy = 43.0f + 85 * (i / 3);
+        auto star = make_star({0, 0}, 40, 18 + 2.5f * i, 32 + 4 * i);
+        canvas->save();
+        canvas->translate(cx + 0.25f * i, cy + 0.1f * i);
+        canvas->rotate(i * gFloatPI / 36);
+        draw_aa_shape(canvas, *star, {0.2f, i / 8.0f, 0.6f, 0.75f});
+        canvas->restore();
+    }
+}
+
+// paths covering 256x256 or more: anti-aliased by the strip rasterizer
+static void draw_aa_strip(GCanvas* canvas) {
+    canvas->clear({1, 1, 1, 1});
+    draw_aa_shape(canvas, *make_star({256, 256}, 250, 110, 7), {0.9f, 0.5f, 0.1f, 1});
+
+    GPathBuilder bu;
+    bu.addCircle({220.5f, 240.25f}, 170, GPathDirection::kCW);
+    bu.addCircle({220.5f, 240.25f}, 120, GPathDirection::kCCW);
+    draw_aa_shape(canvas, *bu.detach(), {0.1f, 0.4f, 0.9f, 0.6f});
+
+    canvas->save();
+    canvas->translate(300, 290);
+    canvas->rotate(gFloatPI / 7);
+    bu.addRect(GRect::LTRB(-160.3f, -140.7f, 150.2f, 130.6f));
+    draw_aa_shape(canvas, *bu.detach(), {0.2f, 0.8f, 0.3f, 0.5f});
+    canvas->restore();
+}
+
+// radial gradients in each tile mode, plain and under a rotate/scale, then sweeps
+static void draw_radial_sweep(GCanvas* canvas) {
+    canvas->clear({1, 1, 1, 1});
+    const GColor colors[] = {{1, 0, 0, 1}, {1, 0.8f, 0, 0.6f}, {0, 0.4f, 1, 1}};
+    const GTileMode modes[] = {GTileMode::kClamp, GTileMode::kRepeat, GTileMode::kMirror};
+    const auto cell = GRect::LTRB(-40, -40, 40, 40);
+    for (int i = 0; i < 3; ++i) {
+        for (int row = 0; row < 2; ++row) {
+            canvas->save();
+            canvas->translate(43 + 85.0f * i, 43 + 85.0f * row);
+            if (row == 1) {
+                canvas->rotate(gFloatPI / 6);
+                canvas->scale(1, 0.6f);
+            }
+            GPaint paint(GCreateRadialGradient({5, -3}, 18, colors, 3, modes[i]));
+            canvas->drawRect(cell, paint);
+            canvas->restore();
+        }
+        canvas->save();
+        canvas->translate(43 + 85.0f * i, 213);
+        canvas->rotate(i * gFloatPI / 5);
+        canvas->scale(1, 1 - 0.25f * i);
+        GPaint paint(GCreateSweepGradient({0, 0}, i * 0.5f, colors, 3 - (i == 2)));
+        canvas->drawRect(cell, paint);
+        canvas->restore();
+    }
+}
@@ -9,6 +9,7 @@
 #include "image_pa3.cpp"
 #include "image_pa4.cpp"
 #include "image_pa5.cpp"
+#include "image_pa6.cpp"
 
 const GDrawRec gDrawRecs[] = {
     { draw_solid_ramp,  256, 7*28,  "solid_ramp",   1   },
@@ -40,5 +41,10 @@ const GDrawRec gDrawRecs[] = {
     { draw_divided,     512, 512,   "divided", 5 },
     { draw_mirror_ramp, 512, 512,   "mirror_ramp", 5 },
 
+    { draw_aa_supersample, 256, 256, "aa_supersample", 6 },
+    { draw_aa_area,        256, 256, "aa_area",        6 },
+    { draw_aa_strip,       512, 512, "aa_strip",       6 },
+    { draw_radial_sweep,   256, 256, "radial_sweep",   6 },
+
     { nullptr, 0, 0, nullptr },
 };
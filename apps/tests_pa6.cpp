@@ -0,0 +1,1773 @@
+#include "../include/GPath.h"
+#include "../include/GPathBuilder.h"
+#include "../include/GPixel.h"
+#include "../include/GRandom.h"
+#include "../include/GShader.h"
+#include "../GPathPack.h"
+#include "../GSVGPath.h"
+#include "../GStaticPath.h"
+#include "../utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include "tests.h"
+
+static void test_path_arena_derived(GTestStats* stats) {
+    GPathArena arena;
+    GPathBuilder bu;
+    bu.moveTo(10, 10); bu.lineTo(20, 10); bu.quadTo(20, 20, 10, 20);
+    auto path = bu.detach(&arena);
+    auto moved = path->transform(GMatrix::Translate(5, 5));
+    auto quant = path->quantized();
+    //* methods with nothing to change must not hand back the arena's memory either
+    auto same = path->transform(GMatrix());
+    auto offset = path->offset(0, 0);
+    auto simple = path->simplified();
+    EXPECT_TRUE(stats, same.get() != path.get() && offset.get() != path.get());
+    path = nullptr;
+
+    // recycle the arena, overwriting the memory the original path was in
+    arena.reset();
+    for (int i = 0; i < 100; ++i) {
+        bu.addCircle({50, 50}, 10);
+        bu.detach(&arena);
+    }
+
+    for (const auto& p : {moved, quant, same, offset, simple}) {
+        const GPathVerb verbs[] = {kMove, kLine, kQuad};
+        GPath::Iter iter(*p);
+        GPoint pts[GPath::kMaxNextPoints];
+        for (auto v : verbs) {
+            auto next = iter.next(pts);
+            EXPECT_TRUE(stats, next.has_value() && next.value() == v);
+        }
+        EXPECT_FALSE(stats, iter.next(pts).has_value());
+    }
+    EXPECT_TRUE(stats, moved->bounds() == GRect::LTRB(15, 15, 25, 25));
+    EXPECT_TRUE(stats, same->bounds() == GRect::LTRB(10, 10, 20, 20));
+    EXPECT_TRUE(stats, simple->bounds() == GRect::LTRB(10, 10, 20, 20));
+}
+
+static void test_draw_rects_match_draw_rect(GTestStats* stats) {
+    const int w = 40, h = 40;
+    GPixel batch[w*h], single[w*h];
+    GBitmap batchBM(w, h, w*4, batch, false), singleBM(w, h, w*4, single, false);
+
+    const GRect rects[] = {
+        GRect::LTRB(1.4f, 2.5f, 9.6f, 7.5f),
+        GRect::LTRB(3.5f, 0.2f, 5.5f, 12.7f),
+        GRect::LTRB(-4.2f, 8.8f, 14.3f, 11.4f),
+        GRect::LTRB(6, 6, 6.4f, 20),
+    };
+    const GColor colors[] = {
+        {1, 0, 0, 0.5f}, {0, 1, 0, 0.75f}, {0, 0, 1, 0.25f}, {1, 1, 0, 1},
+    };
+    const GMatrix ctms[] = {
+        GMatrix(),
+        GMatrix::Translate(0.3f, 0.6f),
+        GMatrix::Scale(0.77f, 1.3f),
+        GMatrix::Translate(0.3f, 0.6f) * GMatrix::Scale(2.3f, 1.7f),
+        GMatrix::Translate(30, 2) * GMatrix::Scale(-1.5f, 1),
+    };
+    GPaint paint({0.5f, 0.25f, 0.75f, 0.5f});
+
+    for (const auto& ctm : ctms) {
+        for (bool withColors : {false, true}) {
+            memset(batch, 0, sizeof(batch));
+            memset(single, 0, sizeof(single));
+            auto c0 = GCreateCanvas(batchBM);
+            auto c1 = GCreateCanvas(singleBM);
+            c0->concat(ctm);
+            c1->concat(ctm);
+            if (withColors) {
+                c0->drawRects(rects, colors, 4, paint);
+            } else {
+                c0->drawRects(rects, 4, paint);
+            }
+            for (int i = 0; i < 4; ++i) {
+                if (withColors) {
+                    paint.setColor(colors[i]);
+                }
+                c1->drawRect(rects[i], paint);
+            }
+            EXPECT_TRUE(stats, memcmp(batch, single, sizeof(batch)) == 0);
+        }
+    }
+}
+
+static void test_draw_rect_scaled(GTestStats* stats) {
+    const int w = 48, h = 48;
+    GPixel pixels[w*h];
+    GBitmap bm(w, h, w*4, pixels, false);
+    struct {
+        GRect   rect;
+        GMatrix ctm;
+        GIRect  filled;
+    } cases[] = {
+        //* the rect's last row and column were dropped when the ctm scaled it
+        { GRect::LTRB(0, 0, 10, 10), GMatrix::Scale(2, 3), GIRect::LTRB(0, 0, 20, 30) },
+        { GRect::LTRB(1, 2, 5, 7), GMatrix::Translate(3, 1) * GMatrix::Scale(4, 5),
+          GIRect::LTRB(7, 11, 23, 36) },
+        { GRect::LTRB(0.2f, 0.3f, 6.1f, 4.4f), GMatrix::Scale(3, 2), GIRect::LTRB(1, 1, 18, 9) },
+        { GRect::LTRB(0, 0, 10, 10), GMatrix::Translate(40, 0) * GMatrix::Scale(-2, 4.5f),
+          GIRect::LTRB(20, 0, 40, 45) },
+    };
+    for (const auto& c : cases) {
+        memset(pixels, 0, sizeof(pixels));
+        auto canvas = GCreateCanvas(bm);
+        canvas->concat(c.ctm);
+        canvas->drawRect(c.rect, GPaint({1, 1, 1, 1}));
+        bool exact = true;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                bool inside = x >= c.filled.left && x < c.filled.right &&
+                              y >= c.filled.top && y < c.filled.bottom;
+                exact &= (pixels[y * w + x] != 0) == inside;
+            }
+        }
+        EXPECT_TRUE(stats, exact);
+    }
+}
+
+static void test_matrix_set_type(GTestStats* stats) {
+    GMatrix m;
+    EXPECT_TRUE(stats, m.isIdentity());
+    EXPECT_EQ(stats, m[4], 0.0f);
+    m.set(4, 3);
+    EXPECT_EQ(stats, m.getType(), (unsigned)GMatrix::kTranslate_Mask);
+    m.set(0, 2);
+    EXPECT_EQ(stats, m.getType(), (unsigned)(GMatrix::kTranslate_Mask | GMatrix::kScale_Mask));
+    m.set(1, 0.5f);
+    EXPECT_FALSE(stats, m.isScaleTranslate());
+    m.set(0, 1); m.set(1, 0); m.set(4, 0);
+    EXPECT_TRUE(stats, m.isIdentity());
+}
+
+static std::vector<char> read_file(const char file[]) {
+    std::vector<char> bytes;
+    if (FILE* f = fopen(file, "rb")) {
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            bytes.insert(bytes.end(), buffer, buffer + n);
+        }
+        fclose(f);
+    }
+    return bytes;
+}
+
+static void write_file(const char file[], const char data[], size_t size) {
+    if (FILE* f = fopen(file, "wb")) {
+        fwrite(data, 1, size, f);
+        fclose(f);
+    }
+}
+
+static bool same_path(const GPath& a, const GPath& b) {
+    GPath::Iter ia(a), ib(b);
+    GPoint pa[GPath::kMaxNextPoints], pb[GPath::kMaxNextPoints];
+    for (;;) {
+        auto va = ia.next(pa);
+        auto vb = ib.next(pb);
+        if (va.has_value() != vb.has_value()) {
+            return false;
+        }
+        if (!va.has_value()) {
+            return true;
+        }
+        if (va.value() != vb.value()) {
+            return false;
+        }
+        const int counts[] = {1, 2, 3, 4};  // for kMove, kLine, kQuad, kCubic
+        for (int i = 0; i < counts[va.value()]; ++i) {
+            if (pa[i] != pb[i]) {
+                return false;
+            }
+        }
+    }
+}
+
+static void test_path_pack_round_trip(GTestStats* stats) {
+    const char* file = "_test_path_pack.bin";
+
+    GPathBuilder bu;
+    bu.addRect(GRect::LTRB(1, 2, 30, 40));
+    auto rect = bu.detach();
+    bu.addCircle({50, 60}, 10);
+    auto circle = bu.detach();
+    bu.moveTo(0, 0); bu.quadTo(10, 0, 10, 10); bu.cubicTo(5, 20, 0, 15, -5, 10);
+    bu.moveTo(20, 20); bu.lineTo(25, 30);
+    auto curves = bu.detach();
+    auto scaled = circle->transform(GMatrix::Translate(3, 4) * GMatrix::Scale(-2, 0.5f));
+
+    const GPath* paths[] = {rect.get(), circle.get(), curves.get(), scaled.get()};
+    GPaint paints[4];
+    paints[0] = GPaint({1, 0, 0, 1});
+    paints[1] = GPaint({0, 0.5f, 1, 0.25f});
+    paints[1].setBlendMode(GBlendMode::kDstOver);
+    paints[2].setAntiAlias(true);
+    paints[3].setBlendMode(GBlendMode::kXor);
+
+    EXPECT_FALSE(stats, GPathPack::Write(file, paths, paints, -1));
+    EXPECT_TRUE(stats, GPathPack::Write(file, paths, paints, 4));
+    auto pack = GPathPack::Open(file);
+    EXPECT_PTR(stats, pack.get());
+    if (!pack) {
+        return;
+    }
+    EXPECT_EQ(stats, pack->count(), 4);
+    for (int i = 0; i < 4; ++i) {
+        auto path = pack->path(i);
+        EXPECT_PTR(stats, path.get());
+        if (!path) {
+            continue;
+        }
+        EXPECT_TRUE(stats, same_path(*path, *paths[i]));
+        GRect oval, original;
+        EXPECT_EQ(stats, path->isOval(&oval), paths[i]->isOval(&original));
+        if (paths[i]->isOval(nullptr)) {
+            EXPECT_TRUE(stats, oval == original);
+        }
+
+        auto paint = pack->paint(i);
+        EXPECT_TRUE(stats, paint.getColor() == paints[i].getColor());
+        EXPECT_TRUE(stats, paint.getBlendMode() == paints[i].getBlendMode());
+        EXPECT_EQ(stats, paint.isAntiAlias(), paints[i].isAntiAlias());
+    }
+
+    //* a file cut short (the last by its final verb and padding): either Open() fails, or the
+    //  record whose data is cut off gives null
+    auto bytes = read_file(file);
+    for (size_t size : {size_t(0), size_t(10), size_t(100), bytes.size() - 4}) {
+        write_file(file, bytes.data(), size);
+        auto cut = GPathPack::Open(file);
+        if (cut) {
+            EXPECT_EQ(stats, cut->count(), 4);
+            EXPECT_NULL(stats, cut->path(3).get());
+        }
+    }
+
+    //* a NaN point makes its path invalid, and an out of range color is pinned to [0, 1]
+    {
+        auto forged = bytes;
+        const GPoint corner = {30, 2};  // the rect's second point
+        const float color[] = {0, 0.5f, 1, 0.25f};  // paints[1]
+        auto pt = std::search(forged.begin(), forged.end(), reinterpret_cast<const char*>(&corner),
+                              reinterpret_cast<const char*>(&corner) + sizeof(corner));
+        auto col = std::search(forged.begin(), forged.end(), reinterpret_cast<const char*>(color),
+                               reinterpret_cast<const char*>(color) + sizeof(color));
+        EXPECT_TRUE(stats, pt != forged.end() && col != forged.end());
+        if (pt != forged.end() && col != forged.end()) {
+            const GPoint nan = {30, NAN};
+            const float badColor[] = {NAN, 7, -3, 0.25f};
+            std::copy_n(reinterpret_cast<const char*>(&nan), sizeof(nan), pt);
+            std::copy_n(reinterpret_cast<const char*>(badColor), sizeof(badColor), col);
+            write_file(file, forged.data(), forged.size());
+            auto pack = GPathPack::Open(file);
+            EXPECT_PTR(stats, pack.get());
+            if (pack) {
+                EXPECT_NULL(stats, pack->path(0).get());
+                EXPECT_TRUE(stats, pack->paint(1).getColor() == GColor::RGBA(0, 1, 0, 0.25f));
+            }
+        }
+    }
+
+    //* move the circle's first point: the oval flag no longer holds, so the path isn't an oval
+    GPoint first;
+    GPath::Iter(*circle).next(&first);  // the move
+    auto at = std::search(bytes.begin(), bytes.end(), reinterpret_cast<const char*>(&first),
+                          reinterpret_cast<const char*>(&first) + sizeof(first));
+    EXPECT_TRUE(stats, at != bytes.end());
+    if (at != bytes.end()) {
+        const GPoint moved = {first.x + 1, first.y};
+        std::copy_n(reinterpret_cast<const char*>(&moved), sizeof(moved), at);
+        write_file(file, bytes.data(), bytes.size());
+        auto forged = GPathPack::Open(file);
+        auto path = forged ? forged->path(1) : nullptr;
+        EXPECT_PTR(stats, path.get());
+        EXPECT_FALSE(stats, path && path->isOval(nullptr));
+    }
+    remove(file);
+}
+
+static std::vector<GPathVerb> path_verbs(const GPath& path) {
+    std::vector<GPathVerb> verbs;
+    GPath::Iter iter(path);
+    GPoint pts[GPath::kMaxNextPoints];
+    while (auto v = iter.next(pts)) {
+        verbs.push_back(v.value());
+    }
+    return verbs;
+}
+
+static void test_path_simplified(GTestStats* stats) {
+    GPathBuilder bu;
+
+    //* nothing to drop: the same path back
+    bu.addRect(GRect::LTRB(0, 0, 10, 10));
+    bu.addCircle({20, 20}, 5);
+    auto plain = bu.detach();
+    EXPECT_TRUE(stats, plain->simplified() == plain);
+
+    //* repeated points and the middle of straight runs go, the corners stay
+    bu.moveTo(0, 0);
+    bu.lineTo(0, 0); bu.lineTo(4, 0); bu.lineTo(10, 0);
+    bu.lineTo(10, 3); bu.lineTo(10, 3); bu.lineTo(10, 10);
+    bu.lineTo(0, 10);
+    auto runs = bu.detach()->simplified();
+    EXPECT_EQ(stats, runs->countPoints(), size_t(4));
+    EXPECT_TRUE(stats, runs->bounds() == GRect::LTRB(0, 0, 10, 10));
+
+    //* a point past the end of the line is a turn, not part of the run
+    bu.moveTo(0, 0); bu.lineTo(10, 0); bu.lineTo(5, 0); bu.lineTo(5, 5);
+    EXPECT_EQ(stats, bu.detach()->simplified()->countPoints(), size_t(4));
+
+    //* straight curves become lines (and join the run), bent ones stay
+    bu.moveTo(0, 0);
+    bu.quadTo(5, 0, 10, 0);
+    bu.cubicTo(10, 2, 10, 6, 10, 10);
+    bu.cubicTo(5, 15, 5, 5, 0, 10);
+    auto curves = bu.detach()->simplified();
+    const std::vector<GPathVerb> expected = {kMove, kLine, kLine, kCubic};
+    EXPECT_TRUE(stats, path_verbs(*curves) == expected);
+
+    //* controls out of order along the chord double back, so the cubic stays
+    bu.moveTo(0, 0); bu.cubicTo(8, 0, 2, 0, 10, 0); bu.lineTo(5, 5);
+    auto back = bu.detach();
+    EXPECT_TRUE(stats, back->simplified() == back);
+
+    //* contours with no area are dropped
+    bu.moveTo(50, 50); bu.lineTo(60, 60);
+    bu.addRect(GRect::LTRB(0, 0, 10, 10));
+    bu.moveTo(70, 70); bu.lineTo(80, 70); bu.lineTo(90, 70);
+    auto empty = bu.detach()->simplified();
+    EXPECT_EQ(stats, empty->countPoints(), size_t(4));
+    EXPECT_TRUE(stats, empty->bounds() == GRect::LTRB(0, 0, 10, 10));
+
+    //* a contour ending with a curve, then another: left alone
+    bu.moveTo(0, 0); bu.lineTo(10, 0); bu.lineTo(10, 0); bu.quadTo(10, 10, 0, 10);
+    bu.addRect(GRect::LTRB(20, 20, 30, 30));
+    auto open = bu.detach();
+    EXPECT_TRUE(stats, open->simplified() == open);
+
+    //* with pixel-aligned runs the edges are the same, so are the pixels
+    const int w = 16, h = 16;
+    GPixel before[w*h], after[w*h];
+    GBitmap bm0(w, h, w*4, before, false), bm1(w, h, w*4, after, false);
+    memset(before, 0, sizeof(before));
+    memset(after, 0, sizeof(after));
+    bu.moveTo(2, 2); bu.lineTo(7, 2); bu.lineTo(13, 2); bu.lineTo(13, 13);
+    bu.lineTo(13, 13); bu.lineTo(2, 13); bu.lineTo(2, 8);
+    auto path = bu.detach();
+    GCreateCanvas(bm0)->drawPath(*path, GPaint({1, 0, 0, 1}));
+    GCreateCanvas(bm1)->drawPath(*path->simplified(), GPaint({1, 0, 0, 1}));
+    EXPECT_TRUE(stats, memcmp(before, after, sizeof(before)) == 0);
+}
+
+static void test_path_view(GTestStats* stats) {
+    static const GPoint pts[] = {{0, 0}, {5, 0}, {10, 0}, {10, 10}, {0, 10}};
+    static const GPathVerb vbs[] = {kMove, kLine, kLine, kLine, kLine};
+    const GPath view = GPath::View(pts, 5, vbs, 5);
+    EXPECT_TRUE(stats, view.bounds() == GRect::LTRB(0, 0, 10, 10));
+
+    //* nothing to change: a pointer to the view itself, owning nothing
+    auto same = view.transform(GMatrix());
+    EXPECT_TRUE(stats, same.get() == &view);
+    EXPECT_EQ(stats, same.use_count(), 0L);
+
+    //* derived paths own their points, and read the same verbs
+    auto moved = view.transform(GMatrix::Translate(3, 4) * GMatrix::Scale(2, 2));
+    EXPECT_TRUE(stats, moved.get() != &view && moved.use_count() == 1);
+    EXPECT_TRUE(stats, moved->bounds() == GRect::LTRB(3, 4, 23, 24));
+    EXPECT_TRUE(stats, path_verbs(*moved) == path_verbs(view));
+
+    auto quant = view.quantized();
+    EXPECT_TRUE(stats, quant.get() != &view && quant->isQuantized());
+    EXPECT_TRUE(stats, path_verbs(*quant) == path_verbs(view));
+    auto qb = quant->bounds();
+    EXPECT_TRUE(stats, std::abs(qb.left) + std::abs(qb.top) + std::abs(qb.right - 10) +
+                       std::abs(qb.bottom - 10) < 0.01f);
+    EXPECT_TRUE(stats, quant->quantized() == quant);
+
+    auto simple = view.simplified();
+    EXPECT_TRUE(stats, simple.get() != &view);
+    EXPECT_EQ(stats, simple->countPoints(), size_t(4));
+    EXPECT_TRUE(stats, simple->simplified() == simple);
+
+    //* a path owned by a shared_ptr hands out that ownership instead
+    auto owned = std::make_shared<GPath>(std::vector<GPoint>(pts, pts + 5),
+                                         std::vector<GPathVerb>(vbs, vbs + 5));
+    auto again = owned->transform(GMatrix());
+    EXPECT_TRUE(stats, again == owned && owned.use_count() == 2);
+
+    //* a view of a constexpr builder
+    static constexpr auto kTriangle = [] {
+        GStaticPathBuilder<3> bu;
+        bu.moveTo(1, 1);
+        bu.lineTo(9, 1);
+        bu.lineTo(5, 7);
+        return bu;
+    }();
+    static const GPath triangle = kTriangle.view();
+    EXPECT_TRUE(stats, triangle.bounds() == GRect::LTRB(1, 1, 9, 7));
+    EXPECT_TRUE(stats, triangle.simplified().get() == &triangle);
+}
+
+// the pixels of [path] drawn in white (anti-aliased if [aa]) under [ctm], onto a clear w x h
+static std::vector<GPixel> path_pixels(const GPath& path, bool aa, const GMatrix& ctm, int w,
+                                       int h) {
+    std::vector<GPixel> pixels(w * h, 0);
+    GBitmap bm(w, h, w * 4, pixels.data(), false);
+    GPaint paint({1, 1, 1, 1});
+    paint.setAntiAlias(aa);
+    auto canvas = GCreateCanvas(bm);
+    canvas->concat(ctm);
+    canvas->drawPath(path, paint);
+    return pixels;
+}
+
+static void test_path_level_of_detail(GTestStats* stats) {
+    static_assert(std::is_copy_constructible<GPath>::value &&
+                  std::is_move_constructible<GPath>::value, "GPath stays copyable and movable");
+    const int n = 400;
+    const float r = 100;
+    GPathBuilder bu;
+    for (int i = 0; i < n; ++i) {
+        auto angle = 2 * gFloatPI * i / n;
+        GPoint p = {128 + r * std::cos(angle), 128 + r * std::sin(angle)};
+        if (i == 0) {
+            bu.moveTo(p);
+        } else {
+            bu.lineTo(p);
+        }
+    }
+    auto path = bu.detach();
+
+    //* each level at most halves the points, and its lines stay within tolerance of the circle
+    EXPECT_TRUE(stats, &path->levelOfDetail(0.1f) == path.get());
+    for (float tol : GPath::kLODTolerances) {
+        const auto& lod = path->levelOfDetail(tol);
+        EXPECT_TRUE(stats, &lod != path.get() && 2 * lod.countPoints() <= path->countPoints());
+        std::vector<GPoint> pts;
+        GPath::Iter iter(lod);
+        GPoint next[GPath::kMaxNextPoints];
+        while (auto verb = iter.next(next)) {
+            pts.push_back(verb.value() == kMove ? next[0] : next[1]);
+        }
+        bool within = !pts.empty();
+        for (size_t i = 0; i < pts.size(); ++i) {
+            auto a = pts[i], b = pts[(i + 1) % pts.size()];
+            GPoint mid = {(a.x + b.x) / 2, (a.y + b.y) / 2};
+            within &= std::abs(std::hypot(a.x - 128, a.y - 128) - r) < 0.01f;
+            within &= std::hypot(mid.x - 128, mid.y - 128) >= r - tol - 0.01f;
+        }
+        EXPECT_TRUE(stats, within);
+    }
+    //* a copy shares the levels it has the same points for
+    GPath copy(*path);
+    EXPECT_TRUE(stats, &copy.levelOfDetail(1) == &path->levelOfDetail(1));
+
+    //* drawPath draws the level for the device tolerance (0.25 pixels) at scale 0.5 or less, and
+    //* the path itself above that, the same as the chosen one drawn already in device space
+    const int w = 256, h = 256;
+    for (float scale : {0.5f, 0.25f, 0.75f, 1.0f}) {
+        auto ctm = GMatrix::Scale(scale, scale);
+        const auto& chosen = scale <= 0.5f ? path->levelOfDetail(0.25f / scale) : *path;
+        auto drawn = path_pixels(*path, false, ctm, w, h);
+        auto device = path_pixels(*chosen.transform(ctm), false, GMatrix(), w, h);
+        EXPECT_TRUE(stats, drawn == device);
+    }
+
+    //* anti-aliased, the level's coverage stays within its tolerance (a quarter pixel) of the
+    //* path's, in each pixel and in total along the outline
+    auto ctm = GMatrix::Scale(0.5f, 0.5f);
+    auto lod = path_pixels(*path, true, ctm, w, h);
+    auto exact = path_pixels(*path->transform(ctm), true, GMatrix(), w, h);
+    int maxDiff = 0;
+    double sum = 0;
+    for (size_t i = 0; i < lod.size(); ++i) {
+        auto diff = std::abs(GPixel_GetA(lod[i]) - GPixel_GetA(exact[i]));
+        maxDiff = std::max(maxDiff, diff);
+        sum += diff / 255.0;
+    }
+    EXPECT_TRUE(stats, maxDiff <= 64);
+    EXPECT_TRUE(stats, sum <= 2 * gFloatPI * 0.5f * r * 0.25f);
+}
+
+static void test_path_bounds_rotated_circle(GTestStats* stats) {
+    GPathBuilder bu;
+    bu.addCircle({0, 0}, 22.5f);
+    auto circle = bu.detach();
+    //* turned by 45 degrees, each cubic's x or y extremum is (nearly) a division by 0
+    for (float degrees : {0.0f, 30.0f, 45.0f, 90.0f}) {
+        auto m = GMatrix::Translate(160, 96) * GMatrix::Rotate(degrees * gFloatPI / 180);
+        auto b = circle->transform(m)->bounds();
+        EXPECT_TRUE(stats, std::abs(b.left - 137.5f) < 0.1f && std::abs(b.right - 182.5f) < 0.1f &&
+                           std::abs(b.top - 73.5f) < 0.1f && std::abs(b.bottom - 118.5f) < 0.1f);
+    }
+}
+
+// a rect's outline, each side split into [perSide] collinear lines (to reach a point count)
+static std::shared_ptr<GPath> split_rect_path(const GRect& r, int perSide) {
+    const GPoint corners[] = {{r.left, r.top}, {r.right, r.top}, {r.right, r.bottom},
+                              {r.left, r.bottom}, {r.left, r.top}};
+    GPathBuilder bu;
+    bu.moveTo(corners[0]);
+    for (int side = 0; side < 4; ++side) {
+        for (int i = 1; i <= perSide; ++i) {
+            auto t = static_cast<float>(i) / perSide;
+            bu.lineTo(corners[side] + t * (corners[side + 1] - corners[side]));
+        }
+    }
+    return bu.detach();
+}
+
+// draws the path anti-aliased in opaque white, returning each pixel's coverage (its alpha)
+static std::vector<int> aa_coverage(const GPath& path, int w, int h) {
+    std::vector<GPixel> pixels(w * h, 0);
+    GBitmap bm(w, h, w * 4, pixels.data(), false);
+    GPaint paint({1, 1, 1, 1});
+    paint.setAntiAlias(true);
+    GCreateCanvas(bm)->drawPath(path, paint);
+    std::vector<int> alpha(w * h);
+    for (int i = 0; i < w * h; ++i) {
+        alpha[i] = GPixel_GetA(pixels[i]);
+    }
+    return alpha;
+}
+
+// every pixel's coverage is within tol (of 255) of the rect's area in it, and the total is
+// within sumTol of the rect's area
+static void expect_rect_coverage(GTestStats* stats, const GPath& path, const GRect& r, int w,
+                                 int h, int tol, float sumTol) {
+    auto alpha = aa_coverage(path, w, h);
+    bool pixelsOK = true;
+    double sum = 0;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            auto cx = std::max(0.0f, std::min(x + 1.0f, r.right) - std::max(x + 0.0f, r.left));
+            auto cy = std::max(0.0f, std::min(y + 1.0f, r.bottom) - std::max(y + 0.0f, r.top));
+            auto a = alpha[y * w + x];
+            pixelsOK &= std::abs(a - 255 * cx * cy) <= tol;
+            sum += a / 255.0;
+        }
+    }
+    EXPECT_TRUE(stats, pixelsOK);
+    EXPECT_TRUE(stats, std::abs(sum - r.width() * r.height()) <= sumTol);
+}
+
+// the total coverage of a regular [n]-gon is within sumTol of its area
+static void expect_polygon_coverage(GTestStats* stats, GPoint center, float radius, int n,
+                                    int w, int h, float sumTol) {
+    GPathBuilder bu;
+    for (int i = 0; i < n; ++i) {
+        auto angle = 2 * gFloatPI * i / n;
+        GPoint p = {center.x + radius * std::cos(angle), center.y + radius * std::sin(angle)};
+        if (i == 0) {
+            bu.moveTo(p);
+        } else {
+            bu.lineTo(p);
+        }
+    }
+    double sum = 0;
+    for (auto a : aa_coverage(*bu.detach(), w, h)) {
+        sum += a / 255.0;
+    }
+    auto area = 0.5 * n * radius * radius * std::sin(2 * gFloatPI / n);
+    EXPECT_TRUE(stats, std::abs(sum - area) <= sumTol);
+}
+
+static void test_aa_coverage(GTestStats* stats) {
+    const auto small = GRect::LTRB(2.3f, 3.7f, 17.6f, 11.2f);
+    const auto large = GRect::LTRB(10.25f, 20.5f, 290.75f, 280.3f);
+
+    //* few points, small: the supersampler, exact to a quarter pixel per axis
+    expect_rect_coverage(stats, *split_rect_path(small, 1), small, 24, 16, 64, 1);
+
+    //* 64+ points, small: the area rasterizer, exact (to rounding)
+    expect_rect_coverage(stats, *split_rect_path(small, 16), small, 24, 16, 1, 0.05f);
+    expect_polygon_coverage(stats, {50, 50}, 40, 96, 100, 100, 0.5f);
+
+    //* a clip of 256x256 or more: the strip rasterizer, whatever the point count
+    expect_rect_coverage(stats, *split_rect_path(large, 1), large, 300, 300, 1, 2);
+    expect_rect_coverage(stats, *split_rect_path(large, 16), large, 300, 300, 1, 2);
+    expect_polygon_coverage(stats, {150, 150}, 140, 96, 300, 300, 2);
+}
+
+static void test_triangles_seams(GTestStats* stats) {
+    const int w = 64, h = 64;
+    GPixel pixels[w*h];
+    GBitmap bm(w, h, w*4, pixels, false);
+
+    //* a square as a 5x5 grid of shared (jittered) vertices, each cell split in two
+    const int N = 5;
+    GPoint verts[(N + 1) * (N + 1)];
+    for (int y = 0; y <= N; ++y) {
+        for (int x = 0; x <= N; ++x) {
+            bool inner = x > 0 && x < N && y > 0 && y < N;
+            verts[y * (N + 1) + x] = {x * 8.0f + (inner ? 0.37f * ((x + 2 * y) % 3) : 0),
+                                      y * 8.0f + (inner ? 0.29f * ((2 * x + y) % 3) : 0)};
+        }
+    }
+    int indices[N * N * 6];
+    int* idx = indices;
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            int i = y * (N + 1) + x;
+            const int cell[] = {i, i + 1, i + N + 2, i, i + N + 2, i + N + 1};
+            idx = std::copy(cell, cell + 6, idx);
+        }
+    }
+
+    //* half transparent: a pixel drawn twice, or missed, shows up as a different value
+    const GPaint paint({0, 0, 1, 0.5f});
+    const GPixel once = GPixel_PackARGB(128, 0, 0, 128);
+    for (const auto& ctm : {GMatrix::Translate(10.3f, 9.7f),
+                            GMatrix::Translate(32, 4) * GMatrix::Rotate(0.6f)}) {
+        memset(pixels, 0, sizeof(pixels));
+        auto canvas = GCreateCanvas(bm);
+        canvas->concat(ctm);
+        canvas->drawTriangles(verts, nullptr, indices, N * N * 2, paint);
+
+        // pixels a pixel or more inside the square are each drawn once, the rest at most once
+        auto inv = ctm.invert();
+        bool ok = inv.has_value();
+        for (int y = 0; ok && y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                GPoint p = {x + 0.5f, y + 0.5f};
+                inv->mapPoints(&p, 1);
+                bool inside = p.x > 1 && p.x < 39 && p.y > 1 && p.y < 39;
+                auto px = pixels[y * w + x];
+                if (px != once && (inside || px != 0)) {
+                    ok = false;
+                }
+            }
+        }
+        EXPECT_TRUE(stats, ok);
+    }
+}
+
+static void test_triangles_colors(GTestStats* stats) {
+    const int w = 64, h = 64;
+    GPixel pixels[w*h];
+    GBitmap bm(w, h, w*4, pixels, false);
+    auto near = [](GPixel p, int a, int r, int g, int b, int tol) {
+        return std::abs(GPixel_GetA(p) - a) <= tol && std::abs(GPixel_GetR(p) - r) <= tol &&
+               std::abs(GPixel_GetG(p) - g) <= tol && std::abs(GPixel_GetB(p) - b) <= tol;
+    };
+
+    const GPoint verts[] = {{2, 2}, {62, 2}, {2, 62}};
+    const GColor rgb[] = {{1, 0, 0, 1}, {0, 1, 0, 1}, {0, 0, 1, 1}};
+    const GPaint paint;
+
+    //* each pixel is the blend of the corners by its barycentric weights (at its center)
+    memset(pixels, 0, sizeof(pixels));
+    GCreateCanvas(bm)->drawTriangles(verts, rgb, nullptr, 1, paint);
+    bool ok = true;
+    for (int y = 2; y < 62; ++y) {
+        for (int x = 2; x + y < 63; ++x) {
+            float u = (x + 0.5f - 2) / 60, v = (y + 0.5f - 2) / 60;
+            ok &= near(pixels[y * w + x], 255, int(255 * (1 - u - v) + 0.5f),
+                       int(255 * u + 0.5f), int(255 * v + 0.5f), 1);
+        }
+    }
+    EXPECT_TRUE(stats, ok);
+
+    //* equal corners are the paint's color, exactly
+    const GColor same[] = {{1, 0.5f, 0.25f, 1}, {1, 0.5f, 0.25f, 1}, {1, 0.5f, 0.25f, 1}};
+    memset(pixels, 0, sizeof(pixels));
+    GCreateCanvas(bm)->drawTriangles(verts, same, nullptr, 1, paint);
+    EXPECT_EQ(stats, pixels[10 * w + 10], GPixel_PackARGB(255, 255, 128, 64));
+
+    //* a shader is modulated by the corners' colors: a constant one times gray, white, black
+    GPixel texel = GPixel_PackARGB(255, 200, 100, 50);
+    GBitmap tex(1, 1, 4, &texel, true);
+    GPaint shaded(GCreateBitmapShader(tex, GMatrix()));
+    const GColor grays[] = {{0.5f, 0.5f, 0.5f, 1}, {1, 1, 1, 1}, {0, 0, 0, 1}};
+    const GMatrix ctm = GMatrix::Translate(3, 1);
+    GPixel first[w*h];
+    for (int pass = 0; pass < 2; ++pass) {
+        memset(pixels, 0, sizeof(pixels));
+        auto canvas = GCreateCanvas(bm);
+        canvas->concat(ctm);
+        canvas->drawTriangles(verts, grays, nullptr, 1, shaded);
+        if (pass == 0) {
+            memcpy(first, pixels, sizeof(pixels));
+        }
+    }
+    // near the gray, white and black corners
+    EXPECT_TRUE(stats, near(pixels[3 * w + 5], 255, 100, 50, 25, 3));
+    EXPECT_TRUE(stats, near(pixels[3 * w + 63], 255, 200, 100, 50, 4));
+    EXPECT_TRUE(stats, near(pixels[61 * w + 5], 255, 0, 0, 0, 4));
+    // the shader's context is restored, so drawing again gives the same pixels
+    EXPECT_TRUE(stats, memcmp(first, pixels, sizeof(pixels)) == 0);
+}
+
+// the pixels whose centers are inside the (axis-aligned) ellipse are drawn and the rest are not,
+// skipping those within eps of the edge (where float and double may disagree)
+static bool oval_contains_centers(const GPixel pixels[], int w, int h, GPoint center, double rx,
+                                  double ry, double eps = 1e-4) {
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            auto dx = (x + 0.5 - center.x) / rx, dy = (y + 0.5 - center.y) / ry;
+            auto d = dx * dx + dy * dy;
+            if (std::abs(d - 1) > eps && (d < 1) != (pixels[y * w + x] != 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_oval_containment(GTestStats* stats) {
+    const int w = 48, h = 40;
+    GPixel pixels[w*h];
+    GBitmap bm(w, h, w*4, pixels, false);
+    const GPaint paint({0, 0, 0, 1});
+
+    struct {
+        GRect    rect;
+        GMatrix  ctm;
+        GPoint   center;  // in device space
+        double   rx, ry;
+    } const cases[] = {
+        {GRect::LTRB(3.3f, 4.6f, 40.2f, 31.7f), GMatrix(), {21.75f, 18.15f}, 18.45, 13.55},
+        {GRect::LTRB(0, 0, 10, 6), GMatrix::Translate(5.25f, 8.5f) * GMatrix::Scale(3.5f, 4),
+         {22.75f, 20.5f}, 17.5, 12},
+        // flipped rects, and partly off the device
+        {GRect::LTRB(30, 25, -10, -5), GMatrix(), {10, 10}, 20, 15},
+        {GRect::LTRB(0, 0, 20, 20), GMatrix::Translate(40, 30) * GMatrix::Scale(-1, 1),
+         {30, 40}, 10, 10},
+    };
+    for (const auto& c : cases) {
+        memset(pixels, 0, sizeof(pixels));
+        auto canvas = GCreateCanvas(bm);
+        canvas->concat(c.ctm);
+        canvas->drawOval(c.rect, paint);
+        EXPECT_TRUE(stats, oval_contains_centers(pixels, w, h, c.center, c.rx, c.ry));
+    }
+
+    //* a circle stays a circle under rotation (and uniform scale)
+    memset(pixels, 0, sizeof(pixels));
+    auto canvas = GCreateCanvas(bm);
+    canvas->translate(24.3f, 19.6f);
+    canvas->rotate(0.7f);
+    canvas->scale(1.5f, 1.5f);
+    canvas->drawOval(GRect::LTRB(-10, -10, 10, 10), paint);
+    EXPECT_TRUE(stats, oval_contains_centers(pixels, w, h, {24.3f, 19.6f}, 15, 15, 1e-3));
+
+    //* a path made by addCircle takes the same route, so draws the same pixels
+    GPixel ovalPixels[w*h];
+    GPathBuilder bu;
+    bu.addCircle({20.5f, 17.25f}, 12.6f);
+    auto circle = bu.detach();
+    for (const auto& ctm : {GMatrix(), GMatrix::Translate(2.5f, 1) * GMatrix::Scale(1.2f, 0.8f)}) {
+        memset(pixels, 0, sizeof(pixels));
+        auto c0 = GCreateCanvas(bm);
+        c0->concat(ctm);
+        c0->drawOval(GRect::LTRB(20.5f - 12.6f, 17.25f - 12.6f, 20.5f + 12.6f, 17.25f + 12.6f),
+                     paint);
+        memcpy(ovalPixels, pixels, sizeof(pixels));
+        memset(pixels, 0, sizeof(pixels));
+        auto c1 = GCreateCanvas(bm);
+        c1->concat(ctm);
+        c1->drawPath(*circle, paint);
+        EXPECT_TRUE(stats, memcmp(ovalPixels, pixels, sizeof(pixels)) == 0);
+    }
+
+    //* an ellipse that is rotated is no longer axis-aligned, so it is drawn as a path
+    bu.addCircle({0, 0}, 1);
+    bu.transform(GMatrix::Scale(15, 10));
+    auto ellipse = bu.detach();
+    for (bool asPath : {false, true}) {
+        memset(pixels, 0, sizeof(pixels));
+        canvas = GCreateCanvas(bm);
+        canvas->translate(24, 20);
+        canvas->rotate(0.4f);
+        if (asPath) {
+            canvas->drawPath(*ellipse, paint);
+        } else {
+            canvas->drawOval(GRect::LTRB(-15, -10, 15, 10), paint);
+            memcpy(ovalPixels, pixels, sizeof(pixels));
+        }
+    }
+    EXPECT_TRUE(stats, memcmp(ovalPixels, pixels, sizeof(pixels)) == 0);
+}
+
+// the alpha of every pixel, after drawing the polyline in opaque white
+static std::vector<int> line_alphas(const GPoint pts[], int count, bool aa, const GMatrix& ctm,
+                                    int w, int h) {
+    std::vector<GPixel> pixels(w * h, 0);
+    GBitmap bm(w, h, w * 4, pixels.data(), false);
+    auto canvas = GCreateCanvas(bm);
+    canvas->concat(ctm);
+    GPaint paint({1, 1, 1, 1});
+    paint.setAntiAlias(aa);
+    canvas->drawLines(pts, count, paint);
+    std::vector<int> alpha(w * h);
+    for (int i = 0; i < w * h; ++i) {
+        alpha[i] = GPixel_GetA(pixels[i]);
+    }
+    return alpha;
+}
+
+// a shallow device space segment (p0.x < p1.x) touches one pixel in each column whose center is
+// in [p0.x, p1.x), on the row the line crosses that center in, and no other pixels
+static bool is_aliased_hairline(const std::vector<int>& alpha, int w, int h, GPoint p0,
+                                GPoint p1) {
+    auto slope = (static_cast<double>(p1.y) - p0.y) / (static_cast<double>(p1.x) - p0.x);
+    for (int x = 0; x < w; ++x) {
+        bool spanned = x + 0.5 >= p0.x && x + 0.5 < p1.x;
+        auto y = p0.y + (x + 0.5 - p0.x) * slope;
+        int count = 0;
+        for (int row = 0; row < h; ++row) {
+            if (alpha[row * w + x]) {
+                // allow for the 16.16 stepping when y is next to a row boundary
+                if (std::abs(row + 0.5 - y) > 0.5 + 1e-3) {
+                    return false;
+                }
+                count += 1;
+            }
+        }
+        if (count != (spanned && y >= 0 && y < h ? 1 : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_lines_aliased(GTestStats* stats) {
+    const int w = 32, h = 24;
+    const GMatrix identity;
+
+    const GPoint flat[] = {{2.5f, 5.5f}, {10.5f, 5.5f}};
+    EXPECT_TRUE(stats, is_aliased_hairline(line_alphas(flat, 2, false, identity, w, h), w, h,
+                                           flat[0], flat[1]));
+    const GPoint slanted[] = {{1.2f, 1.7f}, {29.6f, 13.1f}};
+    EXPECT_TRUE(stats, is_aliased_hairline(line_alphas(slanted, 2, false, identity, w, h), w, h,
+                                           slanted[0], slanted[1]));
+    //* drawn backwards, the same pixels
+    const GPoint reversed[] = {slanted[1], slanted[0]};
+    EXPECT_TRUE(stats, line_alphas(reversed, 2, false, identity, w, h) ==
+                       line_alphas(slanted, 2, false, identity, w, h));
+
+    //* a steep line is the same, transposed
+    const GPoint steep[] = {{3.7f, 1.2f}, {9.1f, 22.6f}};
+    auto tall = line_alphas(steep, 2, false, identity, w, h);
+    std::vector<int> transposed(w * h, 0);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (x < h && y < w) {
+                transposed[x * w + y] = tall[y * w + x];
+            }
+        }
+    }
+    EXPECT_TRUE(stats, is_aliased_hairline(transposed, w, h, {1.2f, 3.7f}, {22.6f, 9.1f}));
+
+    //* one pixel wide whatever the scale: the ctm maps the ends, not the width
+    const GPoint small[] = {{0.3f, 0.4f}, {7.1f, 3.3f}};
+    EXPECT_TRUE(stats, is_aliased_hairline(line_alphas(small, 2, false, GMatrix::Scale(4, 4),
+                                                       w, h), w, h, {1.2f, 1.6f}, {28.4f, 13.2f}));
+
+    //* ends far outside the device are clipped, keeping the line's slope
+    const GPoint across[] = {{-1000, -490.25f}, {1000, 509.75f}};
+    EXPECT_TRUE(stats, is_aliased_hairline(line_alphas(across, 2, false, identity, w, h), w, h,
+                                           across[0], across[1]));
+    const GPoint outside[] = {{-10, -10}, {100, -5}, {100, 100}};
+    auto none = line_alphas(outside, 3, false, identity, w, h);
+    EXPECT_TRUE(stats, std::all_of(none.begin(), none.end(), [](int a) { return a == 0; }));
+
+    //* the corners of a polyline are drawn once: half transparent, every pixel is the same
+    const GPoint poly[] = {{2.5f, 2.5f}, {12.5f, 6.5f}, {20.5f, 20.5f}, {28.5f, 18.5f}};
+    std::vector<GPixel> pixels(w * h, 0);
+    GBitmap bm(w, h, w * 4, pixels.data(), false);
+    GCreateCanvas(bm)->drawLines(poly, 4, GPaint({1, 1, 1, 0.5f}));
+    int drawn = 0;
+    bool once = true;
+    for (auto p : pixels) {
+        if (p) {
+            drawn += 1;
+            once &= p == GPixel_PackARGB(128, 128, 128, 128);
+        }
+    }
+    EXPECT_TRUE(stats, once);
+    EXPECT_EQ(stats, drawn, 10 + 14 + 8);  // columns, rows, columns spanned
+}
+
+static void test_lines_antialiased(GTestStats* stats) {
+    const int w = 32, h = 24;
+    const GMatrix identity;
+
+    //* split between the two rows nearest the line, by its distance from their centers
+    const GPoint flat[] = {{2.25f, 5.75f}, {10.75f, 5.75f}};
+    auto alpha = line_alphas(flat, 2, true, identity, w, h);
+    EXPECT_TRUE(stats, std::abs(alpha[5 * w + 6] - 191) <= 1);
+    EXPECT_TRUE(stats, std::abs(alpha[6 * w + 6] - 64) <= 1);
+    //* the end pixels are weighted by how much of them the line spans
+    EXPECT_TRUE(stats, std::abs(alpha[5 * w + 2] - 143) <= 2);
+    EXPECT_TRUE(stats, std::abs(alpha[5 * w + 10] - 143) <= 2);
+    EXPECT_TRUE(stats, alpha[5 * w + 1] == 0 && alpha[5 * w + 11] == 0);
+
+    //* along a slanted line, each column's coverage adds up to one pixel, next to the line
+    const GPoint slanted[] = {{-20, -3.1f}, {50, 31.9f}};
+    alpha = line_alphas(slanted, 2, true, identity, w, h);
+    bool ok = true;
+    for (int x = 0; x < w; ++x) {
+        auto y = -3.1 + (x + 0.5 + 20) * 0.5;
+        int sum = 0;
+        for (int row = 0; row < h; ++row) {
+            auto a = alpha[row * w + x];
+            sum += a;
+            ok &= a == 0 || std::abs(row + 0.5 - y) < 1;
+        }
+        if (y > 0.5 && y < h - 0.5) {
+            ok &= std::abs(sum - 255) <= 2;
+        }
+    }
+    EXPECT_TRUE(stats, ok);
+}
+
+// the line-only contours of the path (closed), as from GPathBuilder::addStroke
+static std::vector<std::vector<GPoint>> path_polygons(const GPath& path) {
+    std::vector<std::vector<GPoint>> polygons;
+    GPath::Iter iter(path);
+    GPoint pts[GPath::kMaxNextPoints];
+    while (auto v = iter.next(pts)) {
+        if (v.value() == kMove) {
+            polygons.push_back({pts[0]});
+        } else {
+            polygons.back().push_back(pts[1]);
+        }
+    }
+    return polygons;
+}
+
+// non-zero winding of the path's (line-only) contours around p
+static bool stroke_contains(const GPath& path, GPoint p) {
+    int winding = 0;
+    for (const auto& poly : path_polygons(path)) {
+        for (size_t i = 0; i < poly.size(); ++i) {
+            auto a = poly[i], b = poly[(i + 1) % poly.size()];
+            auto side = (b.x - a.x) * (p.y - a.y) - (p.x - a.x) * (b.y - a.y);
+            if (a.y <= p.y && b.y > p.y && side > 0) {
+                winding += 1;
+            } else if (b.y <= p.y && a.y > p.y && side < 0) {
+                winding -= 1;
+            }
+        }
+    }
+    return winding != 0;
+}
+
+static std::shared_ptr<GPath> stroke_of(const GPoint pts[], int count, GStrokeJoin join,
+                                        GStrokeCap cap, float miterLimit = 4) {
+    GPathBuilder bu;
+    bu.addPolygon(pts, count);
+    auto path = bu.detach();
+    GStroke stroke;
+    stroke.width = 6;
+    stroke.join = join;
+    stroke.cap = cap;
+    stroke.miterLimit = miterLimit;
+    bu.addStroke(*path, stroke);
+    return bu.detach();
+}
+
+static void test_stroke_caps(GTestStats* stats) {
+    const GPoint line[] = {{10, 10}, {50, 10}};
+    auto butt = stroke_of(line, 2, GStrokeJoin::kMiter, GStrokeCap::kButt);
+    EXPECT_TRUE(stats, butt->bounds() == GRect::LTRB(10, 7, 50, 13));
+    auto square = stroke_of(line, 2, GStrokeJoin::kMiter, GStrokeCap::kSquare);
+    EXPECT_TRUE(stats, square->bounds() == GRect::LTRB(7, 7, 53, 13));
+    EXPECT_TRUE(stats, stroke_contains(*square, {7.5f, 7.5f}));
+
+    //* round caps are half circles: within tolerance of the radius, no corners
+    auto round = stroke_of(line, 2, GStrokeJoin::kMiter, GStrokeCap::kRound);
+    auto b = round->bounds();
+    EXPECT_TRUE(stats, b.left >= 7 && b.left < 7.25f && b.right <= 53 && b.right > 52.75f);
+    EXPECT_TRUE(stats, stroke_contains(*round, {7.5f, 10}) && stroke_contains(*round, {52.5f, 10}));
+    EXPECT_TRUE(stats, stroke_contains(*round, {8, 8}) && !stroke_contains(*round, {7.5f, 7.5f}));
+
+    //* every piece winds the same way, so non-zero winding fills their union
+    int positive = 0, negative = 0;
+    for (const auto& poly : path_polygons(*round)) {
+        float area = 0;
+        for (size_t i = 0; i < poly.size(); ++i) {
+            auto p = poly[i], q = poly[(i + 1) % poly.size()];
+            area += p.x * q.y - q.x * p.y;
+        }
+        positive += area > 0;
+        negative += area < 0;
+    }
+    EXPECT_TRUE(stats, positive == 0 || negative == 0);
+}
+
+static void test_stroke_joins(GTestStats* stats) {
+    //* a right angle at (50, 10): the outer corner is (53, 7)
+    const GPoint corner[] = {{10, 10}, {50, 10}, {50, 50}};
+    auto miter = stroke_of(corner, 3, GStrokeJoin::kMiter, GStrokeCap::kButt);
+    auto bevel = stroke_of(corner, 3, GStrokeJoin::kBevel, GStrokeCap::kButt);
+    auto round = stroke_of(corner, 3, GStrokeJoin::kRound, GStrokeCap::kButt);
+    EXPECT_TRUE(stats, miter->bounds() == GRect::LTRB(10, 7, 53, 50));
+    // inside the miter's square corner, but beyond the radius and the bevel's diagonal
+    EXPECT_TRUE(stats, stroke_contains(*miter, {52.5f, 7.5f}));
+    EXPECT_FALSE(stats, stroke_contains(*bevel, {52.5f, 7.5f}));
+    EXPECT_FALSE(stats, stroke_contains(*round, {52.5f, 7.5f}));
+    // within the radius, but beyond the bevel's diagonal
+    EXPECT_TRUE(stats, stroke_contains(*round, {52, 8}));
+    EXPECT_FALSE(stats, stroke_contains(*bevel, {52, 8}));
+    // and all of them cover the inside of the bend
+    for (const auto& s : {miter, bevel, round}) {
+        EXPECT_TRUE(stats, stroke_contains(*s, {48, 12}) && stroke_contains(*s, {51, 9}));
+    }
+
+    //* a sharp turn's miter is 1 / sin(7 degrees) = 8.2 half widths: over a limit of 4 it bevels
+    const GPoint sharp[] = {{0, 0}, {40, 0}, {0, 10}};
+    auto limited = stroke_of(sharp, 3, GStrokeJoin::kMiter, GStrokeCap::kButt, 4);
+    auto allowed = stroke_of(sharp, 3, GStrokeJoin::kMiter, GStrokeCap::kButt, 10);
+    EXPECT_TRUE(stats, limited->bounds().right < 44);
+    EXPECT_TRUE(stats, allowed->bounds().right > 64 && allowed->bounds().right < 65);
+}
+
+static void test_stroke_closed(GTestStats* stats) {
+    //* a contour ending on its start is closed: a join there (here a bevel), no caps
+    const GPoint closed[] = {{10, 10}, {50, 10}, {50, 50}, {10, 50}, {10, 10}};
+    auto square = stroke_of(closed, 5, GStrokeJoin::kBevel, GStrokeCap::kButt);
+    EXPECT_TRUE(stats, stroke_contains(*square, {8, 9.5f}));
+    EXPECT_FALSE(stats, stroke_contains(*square, {7.5f, 7.5f}));
+    EXPECT_FALSE(stats, stroke_contains(*square, {30, 30}));  // the hole stays open
+
+    //* the same points without the last are open: the butt ends leave that corner uncovered
+    auto open = stroke_of(closed, 4, GStrokeJoin::kBevel, GStrokeCap::kButt);
+    EXPECT_FALSE(stats, stroke_contains(*open, {8, 9.5f}));
+    EXPECT_TRUE(stats, stroke_contains(*open, {52, 48}));
+
+    auto mitered = stroke_of(closed, 5, GStrokeJoin::kMiter, GStrokeCap::kButt);
+    EXPECT_TRUE(stats, mitered->bounds() == GRect::LTRB(7, 7, 53, 53));
+    EXPECT_TRUE(stats, stroke_contains(*mitered, {7.5f, 7.5f}));
+
+    //* addRect leaves its contour open (filling closes it); GStroke::closed strokes it closed too
+    GPathBuilder bu;
+    bu.addRect(GRect::LTRB(10, 10, 50, 50));
+    auto rect = bu.detach();
+    GStroke stroke;
+    stroke.width = 6;
+    bu.addStroke(*rect, stroke);
+    auto openRect = bu.detach();
+    EXPECT_FALSE(stats, stroke_contains(*openRect, {10, 30}));  // the missing last side
+    stroke.closed = true;
+    bu.addStroke(*rect, stroke);
+    auto closedRect = bu.detach();
+    EXPECT_TRUE(stats, closedRect->bounds() == GRect::LTRB(7, 7, 53, 53));
+    EXPECT_TRUE(stats, stroke_contains(*closedRect, {30, 8}) &&
+                       stroke_contains(*closedRect, {7.5f, 7.5f}) &&
+                       stroke_contains(*closedRect, {52.5f, 52.5f}));
+    EXPECT_FALSE(stats, stroke_contains(*closedRect, {30, 30}));
+    EXPECT_TRUE(stats, stroke_contains(*closedRect, {10, 30}));
+    //* a contour already ending on its start is not closed twice, and a line stays open
+    bu.addPolygon(closed, 5);
+    auto loop = bu.detach();
+    bu.addStroke(*loop, stroke);
+    auto closedTwice = bu.detach();
+    stroke.closed = false;
+    bu.addStroke(*loop, stroke);
+    EXPECT_TRUE(stats, same_path(*closedTwice, *bu.detach()));
+    stroke.closed = true;
+    const GPoint line[] = {{10, 10}, {50, 10}};
+    bu.addPolygon(line, 2);
+    bu.addStroke(*bu.detach(), stroke);
+    EXPECT_TRUE(stats, bu.detach()->bounds() == GRect::LTRB(10, 7, 50, 13));
+}
+
+// a path parsed from SVG path data, or null if GParseSVGPath() fails
+static std::shared_ptr<GPath> parse_svg(const char data[]) {
+    GPathBuilder bu;
+    if (!GParseSVGPath(data, strlen(data), &bu)) {
+        return nullptr;
+    }
+    return bu.detach();
+}
+
+// the path is the parse of data, verb for verb and point for point (within tol)
+static bool svg_is(const char data[], const std::vector<GPathVerb>& verbs,
+                   const std::vector<GPoint>& points, float tol = 0) {
+    auto path = parse_svg(data);
+    if (!path || path_verbs(*path) != verbs || path->countPoints() != points.size()) {
+        return false;
+    }
+    GPath::Iter iter(*path);
+    GPoint pts[GPath::kMaxNextPoints];
+    size_t i = 0;
+    while (auto v = iter.next(pts)) {
+        // Iter repeats the previous segment's last point first, but for moves
+        auto first = v.value() == kMove ? 0 : 1;
+        auto count = v.value() == kMove ? 1 : v.value() == kLine ? 2 : v.value() == kQuad ? 3 : 4;
+        for (int k = first; k < count; ++k, ++i) {
+            if (std::abs(pts[k].x - points[i].x) > tol || std::abs(pts[k].y - points[i].y) > tol) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_svg_relative(GTestStats* stats) {
+    //* lower case is relative to the current point, which a close returns to the start
+    EXPECT_TRUE(stats, svg_is("m10 20 l5 5 h10 v-5 z m5 5 l1 1",
+                              {kMove, kLine, kLine, kLine, kLine, kMove, kLine},
+                              {{10, 20}, {15, 25}, {25, 25}, {25, 20}, {10, 20}, {15, 25},
+                               {16, 26}}));
+    EXPECT_TRUE(stats, svg_is("M1 1 c1 0 2 1 2 2 q0 2 -2 2", {kMove, kCubic, kQuad},
+                              {{1, 1}, {2, 1}, {3, 2}, {3, 3}, {3, 5}, {1, 5}}));
+    EXPECT_TRUE(stats, svg_is("M10 10 H20 h5 V0 v5", {kMove, kLine, kLine, kLine, kLine},
+                              {{10, 10}, {20, 10}, {25, 10}, {25, 0}, {25, 5}}));
+}
+
+static void test_svg_reflection(GTestStats* stats) {
+    //* S reflects the last control point of a C or S about the current point, else uses it
+    EXPECT_TRUE(stats, svg_is("M0 0 C10 0 20 10 20 20 S30 40 40 40 s10 0 10 10",
+                              {kMove, kCubic, kCubic, kCubic},
+                              {{0, 0}, {10, 0}, {20, 10}, {20, 20}, {20, 30}, {30, 40},
+                               {40, 40}, {50, 40}, {50, 40}, {50, 50}}));
+    EXPECT_TRUE(stats, svg_is("M0 0 L10 10 S20 20 30 10", {kMove, kLine, kCubic},
+                              {{0, 0}, {10, 10}, {10, 10}, {20, 20}, {30, 10}}));
+    //* T likewise, after a Q or T
+    EXPECT_TRUE(stats, svg_is("M0 0 Q10 10 20 0 T40 0 t20 0", {kMove, kQuad, kQuad, kQuad},
+                              {{0, 0}, {10, 10}, {20, 0}, {30, -10}, {40, 0}, {50, 10},
+                               {60, 0}}));
+    EXPECT_TRUE(stats, svg_is("M0 0 C1 1 2 2 3 3 T10 0", {kMove, kCubic, kQuad},
+                              {{0, 0}, {1, 1}, {2, 2}, {3, 3}, {3, 3}, {10, 0}}));
+}
+
+static void test_svg_arcs(GTestStats* stats) {
+    auto bounds = [](const char data[]) {
+        auto path = parse_svg(data);
+        return path ? path->bounds() : GRect::LTRB(0, 0, 0, 0);
+    };
+    auto near = [](const GRect& a, const GRect& b) {
+        return std::abs(a.left - b.left) < 0.01f && std::abs(a.top - b.top) < 0.01f &&
+               std::abs(a.right - b.right) < 0.01f && std::abs(a.bottom - b.bottom) < 0.01f;
+    };
+    //* the sweep flag picks the side, the large arc flag the long way round
+    EXPECT_TRUE(stats, near(bounds("M0 0 A10 10 0 0 1 20 0"), GRect::LTRB(0, -10, 20, 0)));
+    EXPECT_TRUE(stats, near(bounds("M0 0 A10 10 0 0 0 20 0"), GRect::LTRB(0, 0, 20, 10)));
+    EXPECT_TRUE(stats, near(bounds("M0 0 A20 20 0 0 1 20 0"), GRect::LTRB(0, -2.6795f, 20, 0)));
+    auto large = bounds("M0 0 A20 20 0 1 1 20 0");
+    EXPECT_TRUE(stats, std::abs(large.top + 37.3205f) < 0.05f && std::abs(large.left + 10) < 0.05f);
+    //* radii too small for the chord grow to fit it, and a zero radius is a line
+    EXPECT_TRUE(stats, near(bounds("M0 0 A1 1 0 0 1 20 0"), GRect::LTRB(0, -10, 20, 0)));
+    EXPECT_TRUE(stats, svg_is("M0 0 A0 10 0 0 1 20 0", {kMove, kLine}, {{0, 0}, {20, 0}}));
+    //* the x axis rotation turns the ellipse
+    EXPECT_TRUE(stats, near(bounds("M0 0 A20 10 90 0 1 0 40"), GRect::LTRB(0, 0, 10, 40)));
+    //* flags need no separators, and the arc ends exactly on its end point
+    EXPECT_TRUE(stats, svg_is("M0 0 A10 10 0 0120 0", {kMove, kCubic, kCubic},
+                              {{0, 0}, {0, -5.5228f}, {4.4772f, -10}, {10, -10}, {15.5228f, -10},
+                               {20, -5.5228f}, {20, 0}}, 0.001f));
+    EXPECT_TRUE(stats, svg_is("M5 5 a10 10 0 0 1 20 0", {kMove, kCubic, kCubic},
+                              {{5, 5}, {5, -0.5228f}, {9.4772f, -5}, {15, -5}, {20.5228f, -5},
+                               {25, -0.5228f}, {25, 5}}, 0.001f));
+    EXPECT_NULL(stats, parse_svg("M0 0 A10 10 0 2 1 20 0").get());
+}
+
+static void test_svg_implicit(GTestStats* stats) {
+    //* repeated arguments repeat the command, and a move's are lines
+    EXPECT_TRUE(stats, svg_is("M0 0 L1 1 2 2 3 3", {kMove, kLine, kLine, kLine},
+                              {{0, 0}, {1, 1}, {2, 2}, {3, 3}}));
+    EXPECT_TRUE(stats, svg_is("m1 1 2 2 3 3", {kMove, kLine, kLine},
+                              {{1, 1}, {3, 3}, {6, 6}}));
+    EXPECT_TRUE(stats, svg_is("M0,0c1,1 2,2 3,3,1,1,2,2,3,3", {kMove, kCubic, kCubic},
+                              {{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 5}, {6, 6}}));
+    //* numbers end where the next can't continue them
+    EXPECT_TRUE(stats, svg_is("M-1-2L.5.5l1e1-1E1", {kMove, kLine, kLine},
+                              {{-1, -2}, {0.5f, 0.5f}, {10.5f, -9.5f}}));
+    //* after a close, drawing (but not moving) starts a contour at the last start
+    EXPECT_TRUE(stats, svg_is("M0 0 L10 0 L10 10 Z L5 5",
+                              {kMove, kLine, kLine, kLine, kMove, kLine},
+                              {{0, 0}, {10, 0}, {10, 10}, {0, 0}, {0, 0}, {5, 5}}));
+
+    //* errors stop the parse, keeping what came before
+    EXPECT_NULL(stats, parse_svg("L1 1").get());
+    EXPECT_NULL(stats, parse_svg("M0 0 Z 5 5").get());
+    EXPECT_NULL(stats, parse_svg("M0 0 X").get());
+    GPathBuilder bu;
+    const char partial[] = "M0 0 L1 1 L2";
+    EXPECT_FALSE(stats, GParseSVGPath(partial, strlen(partial), &bu));
+    EXPECT_EQ(stats, bu.detach()->countPoints(), size_t(2));
+}
+
+static void test_svg_numbers(GTestStats* stats) {
+    auto parse_x = [](const char number[]) {
+        char data[96];
+        snprintf(data, sizeof(data), "M%s 0", number);
+        auto path = parse_svg(data);
+        GPoint pts[GPath::kMaxNextPoints] = {{NAN, NAN}};
+        if (path) {
+            GPath::Iter(*path).next(pts);
+        }
+        return pts[0].x;
+    };
+    auto same = [](float a, float b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    };
+
+    const char* numbers[] = {
+        "0", "-0", "1.", ".5e-3", "+7", "1E+2", "00012", "0.1", "3.4028234e38", "1e39", "1e-45",
+        "7e-50", "123456789012345678901234", "0.000000000000000000000000001e30", "16777217",
+    };
+    for (auto n : numbers) {
+        EXPECT_TRUE(stats, same(parse_x(n), strtof(n, nullptr)));
+    }
+
+    //* as strtof, at every magnitude and in every format printf makes
+    GRandom rand(7);
+    const char* formats[] = {"%.9g", "%g", "%.3f", "%.12e", "%.20g", "%.1f"};
+    int mismatches = 0;
+    for (int i = 0; i < 20000; ++i) {
+        auto magnitude = std::pow(10.0f, static_cast<float>(rand.nextU() % 40) - 20);
+        auto value = (rand.nextF() * 2 - 1) * magnitude;
+        char number[64];
+        snprintf(number, sizeof(number), formats[i % 6], static_cast<double>(value));
+        mismatches += !same(parse_x(number), strtof(number, nullptr));
+    }
+    EXPECT_EQ(stats, mismatches, 0);
+}
+
+// the pixels a shader draws over a clear w x h device, under [ctm]
+static std::vector<GPixel> shader_pixels(std::shared_ptr<GShader> shader, const GMatrix& ctm,
+                                         int w, int h) {
+    std::vector<GPixel> pixels(w * h, 0);
+    GBitmap bm(w, h, w * 4, pixels.data(), false);
+    auto canvas = GCreateCanvas(bm);
+    canvas->concat(ctm);
+    canvas->drawRect(GRect::LTRB(-1000, -1000, 1000, 1000), GPaint(shader));
+    return pixels;
+}
+
+// t tiled into [0, 1] like the gradients do
+static float tile_unit(float t, GTileMode mode) {
+    switch (mode) {
+        case GTileMode::kClamp:
+            return std::max(0.0f, std::min(t, 1.0f));
+        case GTileMode::kRepeat:
+            return t - std::floor(t);
+        case GTileMode::kMirror:
+            t = std::abs(t);
+            t = t - 2 * std::floor(t / 2);
+            return t > 1 ? 2 - t : t;
+    }
+    return t;
+}
+
+// the colors at [t] in [0, 1], evenly spaced and interpolated exactly, then premultiplied
+static GPixel gradient_at(const GColor colors[], int count, double t) {
+    auto u = t * (count - 1);
+    auto k = std::min(static_cast<int>(u), std::max(count - 2, 0));
+    auto f = static_cast<float>(u - k);
+    auto c = count == 1 ? colors[0] : (1 - f) * colors[k] + f * colors[k + 1];
+    return GPixel_PackARGB(GRoundToInt(c.a * 255), GRoundToInt(c.r * c.a * 255),
+                           GRoundToInt(c.g * c.a * 255), GRoundToInt(c.b * c.a * 255));
+}
+
+static bool near_pixel(GPixel a, GPixel b, int tol) {
+    for (int shift : {0, 8, 16, 24}) {
+        if (std::abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF)) > tol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// every pixel the shader draws under [ctm] is within tol of [t_at] (the gradient's t at a local
+// point) tiled and looked up exactly, except where t_at returns NaN (near a discontinuity).
+// The colors all have some alpha, so a clear pixel is one the rect's edges left out (the
+// non-AA polygon fill leaves some edge pixels out when rotated), and is not compared. The
+// gradients look t up in a 256 entry table, which may be 1/510 off, so a channel may be off by
+// (count - 1) / 2, plus rounding.
+template <typename TAt>
+static bool gradient_matches(std::shared_ptr<GShader> shader, const GColor colors[], int count,
+                             GTileMode mode, const GMatrix& ctm, TAt t_at) {
+    const int w = 96, h = 96, tol = (count + 2) / 2;
+    auto pixels = shader_pixels(shader, ctm, w, h);
+    auto inverse = *ctm.invert();
+    int compared = 0;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            auto t = t_at(inverse * GPoint{x + 0.5f, y + 0.5f});
+            auto pixel = pixels[y * w + x];
+            if (std::isnan(t) || pixel == 0) {
+                continue;
+            }
+            if (!near_pixel(pixel, gradient_at(colors, count, tile_unit(t, mode)), tol)) {
+                return false;
+            }
+            compared += 1;
+        }
+    }
+    return compared >= w * h * 3 / 4;
+}
+
+static void test_gradient_radial(GTestStats* stats) {
+    const GColor colors[] = {{1, 0, 0, 1}, {0, 1, 0, 0.5f}, {0, 0, 1, 1}};
+    const GPoint center = {40, 50};
+    const float radius = 30;
+    EXPECT_NULL(stats, GCreateRadialGradient(center, radius, colors, 0).get());
+    EXPECT_NULL(stats, GCreateRadialGradient(center, 0, colors, 3).get());
+    EXPECT_NULL(stats, GCreateRadialGradient(center, -5, colors, 3).get());
+
+    //* against the distance from the center, in each tile mode, under a rotate/scale ctm
+    const GMatrix ctms[] = {
+        GMatrix(),
+        GMatrix::Translate(48, 40) * GMatrix::Rotate(0.6f) * GMatrix::Scale(1.3f, 0.7f) *
+            GMatrix::Translate(-40, -50),
+    };
+    for (auto mode : {GTileMode::kClamp, GTileMode::kRepeat, GTileMode::kMirror}) {
+        for (const auto& ctm : ctms) {
+            auto shader = GCreateRadialGradient(center, radius, colors, 3, mode);
+            EXPECT_TRUE(stats, gradient_matches(shader, colors, 3, mode, ctm, [&](GPoint p) {
+                auto t = std::hypot(p.x - center.x, p.y - center.y) / radius;
+                // repeat jumps from the last color back to the first at each whole t
+                auto f = t - std::floor(t);
+                return mode == GTileMode::kRepeat && (f < 0.02f || f > 0.98f) ? NAN : t;
+            }));
+        }
+    }
+    //* one color is constant
+    auto one = GCreateRadialGradient(center, radius, colors, 1);
+    EXPECT_TRUE(stats, one->asConstantColor().has_value() &&
+                       one->asConstantColor().value() == gradient_at(colors, 1, 0));
+}
+
+static void test_gradient_sweep(GTestStats* stats) {
+    const GColor colors[] = {{1, 0, 0, 1}, {0, 1, 0, 0.5f}, {0, 0, 1, 1}, {1, 1, 0, 1}};
+    const GPoint center = {48, 40};
+    const float start = 0.7f;
+    EXPECT_NULL(stats, GCreateSweepGradient(center, start, colors, 0).get());
+
+    //* against the angle from the start, once around, under a rotate/scale ctm
+    const GMatrix ctms[] = {
+        GMatrix(),
+        GMatrix::Translate(50, 44) * GMatrix::Rotate(-1.1f) * GMatrix::Scale(0.8f, 1.4f) *
+            GMatrix::Translate(-48, -40),
+    };
+    for (const auto& ctm : ctms) {
+        auto shader = GCreateSweepGradient(center, start, colors, 4);
+        EXPECT_TRUE(stats, gradient_matches(shader, colors, 4, GTileMode::kClamp, ctm,
+                                            [&](GPoint p) {
+            auto dx = p.x - center.x, dy = p.y - center.y;
+            auto t = (std::atan2(dy, dx) - start) / (2 * gFloatPI);
+            t -= std::floor(t);
+            // the last color meets the first at the start angle, and every angle meets at
+            // the center
+            return t < 0.01f || t > 0.99f || std::hypot(dx, dy) < 2 ? NAN : t;
+        }));
+    }
+}
+
+static void test_draw_paths_match_draw_path(GTestStats* stats) {
+    const int w = 64, h = 64;
+    GPathBuilder bu;
+    std::vector<std::shared_ptr<GPath>> paths;
+    bu.addRect(GRect::LTRB(4.3f, 5.6f, 40.2f, 30.7f));
+    paths.push_back(bu.detach());
+    bu.addCircle({30, 34}, 17.5f);
+    paths.push_back(bu.detach());
+    bu.moveTo(10, 50); bu.quadTo(32, -10, 58, 52); bu.cubicTo(40, 20, 25, 70, 10, 50);
+    paths.push_back(bu.detach());
+    bu.addRect(GRect::LTRB(20, 8, 60, 44));
+    bu.addRect(GRect::LTRB(28, 16, 52, 36), GPathDirection::kCCW);
+    paths.push_back(bu.detach());
+    bu.addCircle({12, 12}, 9);
+    paths.push_back(bu.detach());
+
+    //* mixed paints: solid in several modes, a shader shared by two paints, and anti-aliased
+    //* (a new shader for each draw, as undoing its context may round its matrix)
+    auto make_paints = [](int aaMask) {
+        auto shader = GCreateLinearGradient({0, 0}, {40, 20}, {1, 0, 0, 1}, {0, 0, 1, 0.5f},
+                                            GTileMode::kMirror);
+        std::vector<GPaint> paints = {
+            GPaint(GColor{0.2f, 0.6f, 0.9f, 0.7f}), GPaint(shader),
+            GPaint(GColor{0.9f, 0.8f, 0.1f, 1}), GPaint(shader),
+            GPaint(GColor{0.1f, 0.9f, 0.3f, 0.5f}),
+        };
+        const GBlendMode modes[] = {GBlendMode::kSrcOver, GBlendMode::kXor, GBlendMode::kDstOver,
+                                    GBlendMode::kSrcATop, GBlendMode::kDstOut};
+        for (size_t i = 0; i < paints.size(); ++i) {
+            paints[i].setBlendMode(modes[i]).setAntiAlias((aaMask >> i) & 1);
+        }
+        return paints;
+    };
+
+    std::vector<const GPath*> ptrs;
+    for (const auto& path : paths) {
+        ptrs.push_back(path.get());
+    }
+    const GMatrix ctms[] = {
+        GMatrix(),
+        GMatrix::Translate(32, 30) * GMatrix::Rotate(0.4f) * GMatrix::Scale(1.2f, 0.8f) *
+            GMatrix::Translate(-32, -32),
+        GMatrix::Scale(0.4f, 0.4f),
+    };
+    for (const auto& ctm : ctms) {
+        for (int aaMask : {0, 0b00110, 0b11111}) {
+            GPixel batch[w * h], single[w * h];
+            GBitmap batchBM(w, h, w * 4, batch, false), singleBM(w, h, w * 4, single, false);
+            auto batchCanvas = GCreateCanvas(batchBM), singleCanvas = GCreateCanvas(singleBM);
+            for (auto canvas : {batchCanvas.get(), singleCanvas.get()}) {
+                canvas->clear({0.5f, 0.5f, 0.5f, 0.6f});
+                canvas->concat(ctm);
+            }
+            //* the same pixels as drawing each path in turn
+            auto paints = make_paints(aaMask);
+            batchCanvas->drawPaths(ptrs.data(), paints.data(), static_cast<int>(ptrs.size()));
+            paints = make_paints(aaMask);
+            for (size_t i = 0; i < ptrs.size(); ++i) {
+                singleCanvas->drawPath(*ptrs[i], paints[i]);
+            }
+            EXPECT_TRUE(stats, std::equal(batch, batch + w * h, single));
+        }
+    }
+}
+
+// forwards to a shader, but makes none of its capability promises, so the canvas always calls
+// shadeRow() for every pixel (the slow path the fast ones must match)
+class PlainShader : public GShader {
+public:
+    explicit PlainShader(std::shared_ptr<GShader> shader) : fShader(std::move(shader)) {}
+
+    bool isOpaque() override { return fShader->isOpaque(); }
+    bool setContext(const GMatrix& ctm) override { return fShader->setContext(ctm); }
+    void shadeRow(int x, int y, int count, GPixel row[]) override {
+        fShader->shadeRow(x, y, count, row);
+    }
+
+private:
+    std::shared_ptr<GShader> fShader;
+};
+
+// the pixels of rects and triangles drawn with [shader] under [ctm], over a gray background
+static std::vector<GPixel> shaded_pixels(std::shared_ptr<GShader> shader, const GMatrix& ctm,
+                                         GBlendMode mode) {
+    const int w = 40, h = 40;
+    std::vector<GPixel> pixels(w * h);
+    GBitmap bm(w, h, w * 4, pixels.data(), false);
+    auto canvas = GCreateCanvas(bm);
+    canvas->clear({0.5f, 0.25f, 0.75f, 0.6f});
+    canvas->concat(ctm);
+    GPaint paint(shader);
+    paint.setBlendMode(mode);
+    //* rows past the bitmap's edges (clamped), and rows inside it (read straight out of it)
+    canvas->drawRect(GRect::LTRB(-3, 2, 36, 25), paint);
+    canvas->drawRect(GRect::LTRB(1, 1, 15, 11), paint);
+    canvas->drawRect(GRect::LTRB(8, 6, 22, 16), paint);
+    const GPoint tri[] = {{5, 44}, {38, 20}, {30, 41}};
+    canvas->drawConvexPolygon(tri, 3, paint);
+    GPathBuilder bu;
+    bu.addPolygon(tri, 3);
+    canvas->drawPath(*bu.detach()->offset(-4, -12), paint);
+    return pixels;
+}
+
+static void test_shader_fast_paths(GTestStats* stats) {
+    GPixel src[16 * 12];
+    for (int i = 0; i < 16 * 12; ++i) {
+        auto a = 80 + i % 7 * 25;
+        src[i] = GPixel_PackARGB(a, a * (i % 5) / 4, a * (i % 3) / 2, a * (i % 11) / 10);
+    }
+    GBitmap bitmap(16, 12, 16 * 4, src, false);
+    GPixel one = GPixel_PackARGB(200, 100, 50, 0);
+    GBitmap single(1, 1, 4, &one, false);
+
+    const GColor colors[] = {{1, 0, 0, 1}, {0, 0.5f, 1, 0.5f}};
+    //* a new shader for each draw, as setContext() changes it
+    const std::function<std::shared_ptr<GShader>()> shaders[] = {
+        //* asConstantColor
+        [&] { return GCreateLinearGradient({0, 0}, {30, 10}, colors, 1); },
+        [&] { return GCreateBitmapShader(single, GMatrix::Scale(4, 4)); },
+        //* asAffineBitmap, including rows clamped at its edges and non-integer translates
+        [&] { return GCreateBitmapShader(bitmap, GMatrix()); },
+        [&] { return GCreateBitmapShader(bitmap, GMatrix::Translate(7, 5)); },
+        [&] { return GCreateBitmapShader(bitmap, GMatrix::Translate(2.5f, 3.7f)); },
+        [&] { return GCreateBitmapShader(bitmap, GMatrix::Translate(-1.49f, 0.51f)); },
+        //* row and column constant
+        [&] { return GCreateLinearGradient({0, 3}, {0, 30}, colors, 2); },
+        [&] { return GCreateLinearGradient({2, 0}, {33, 0}, colors, 2, GTileMode::kMirror); },
+        [&] { return GCreateBitmapShader(bitmap, GMatrix::Scale(3, 1)); },
+    };
+    const GMatrix ctms[] = {
+        GMatrix(),
+        GMatrix::Translate(3, -2),
+        GMatrix::Translate(0.5f, 0.25f),
+        GMatrix::Scale(1, 1.5f),
+    };
+    for (const auto& make : shaders) {
+        bool same = true;
+        for (const auto& ctm : ctms) {
+            for (auto mode : {GBlendMode::kSrcOver, GBlendMode::kSrc, GBlendMode::kDstATop}) {
+                auto fast = shaded_pixels(make(), ctm, mode);
+                same &= fast == shaded_pixels(std::make_shared<PlainShader>(make()), ctm, mode);
+            }
+        }
+        EXPECT_TRUE(stats, same);
+    }
+}
+
+// a random premul pixel with alpha 0, 255, or in between, for class 0, 1 or 2
+static GPixel pixel_of_class(GRandom& rand, int cls) {
+    int a = cls == 0 ? 0 : cls == 1 ? 255 : rand.nextRange(1, 254);
+    return GPixel_PackARGB(a, rand.nextRange(0, a), rand.nextRange(0, a), rand.nextRange(0, a));
+}
+
+static void test_blend_pixels_row_runs(GTestStats* stats) {
+    const int n = 23;  // not a multiple of 4, so every run ends at each lane of the SSE2 scan
+    GRandom rand;
+    std::vector<std::vector<GPixel>> rows;
+    //* all transparent, all opaque, all partial
+    for (int cls = 0; cls < 3; ++cls) {
+        rows.emplace_back();
+        for (int i = 0; i < n; ++i) {
+            rows.back().push_back(pixel_of_class(rand, cls));
+        }
+    }
+    //* runs of every length up to 9, so they start and end on both sides of 4 pixel boundaries
+    for (int start = 0; start < 3; ++start) {
+        rows.emplace_back();
+        for (int len = 1, cls = start; rows.back().size() < size_t(n); ++len, cls = (cls + 1) % 3) {
+            for (int i = 0; i < len % 10 && rows.back().size() < size_t(n); ++i) {
+                rows.back().push_back(pixel_of_class(rand, cls));
+            }
+        }
+    }
+    //* mixed at random
+    for (int r = 0; r < 20; ++r) {
+        rows.emplace_back();
+        for (int i = 0; i < n; ++i) {
+            rows.back().push_back(pixel_of_class(rand, rand.nextRange(0, 2)));
+        }
+    }
+
+    using BlendProc = void (*)(GPixel, GPixel*);
+    const BlendProc procs[] = {
+        blendClear, blendSrc, blendDst, blendSrcOver, blendDstOver, blendSrcIn, blendDstIn,
+        blendSrcOut, blendDstOut, blendSrcATop, blendDstATop, blendXor,
+    };
+    bool runsOK = true, pixelsOK = true;
+    for (const auto& src : rows) {
+        //* each run is as long as a scalar scan of the alpha classes says
+        for (int i = 0; i < n; ++i) {
+            int len = 1;
+            while (i + len < n && alpha_class(src[i + len]) == alpha_class(src[i])) {
+                len++;
+            }
+            runsOK &= alpha_run_length(src.data() + i, n - i) == len;
+        }
+        //* and blending the runs gives the pixels of blending each pixel with the full mode
+        std::vector<GPixel> dst(n);
+        for (auto& d : dst) {
+            d = pixel_of_class(rand, rand.nextRange(0, 2));
+        }
+        for (int m = 0; m <= static_cast<int>(GBlendMode::kXor); ++m) {
+            auto expected = dst, actual = dst;
+            for (int i = 0; i < n; ++i) {
+                procs[m](src[i], &expected[i]);
+            }
+            blend_pixels_row(actual.data(), n, src.data(), static_cast<GBlendMode>(m));
+            pixelsOK &= actual == expected;
+        }
+    }
+    EXPECT_TRUE(stats, runsOK);
+    EXPECT_TRUE(stats, pixelsOK);
+}
+
+// a w x h bitmap of random premul pixels, backed by [storage]
+static GBitmap random_bitmap(int w, int h, std::vector<GPixel>* storage) {
+    GRandom rand(w * 31 + h);
+    storage->resize(w * h);
+    for (auto& p : *storage) {
+        p = pixel_of_class(rand, rand.nextRange(1, 2));
+    }
+    return GBitmap(w, h, w * 4, storage->data(), false);
+}
+
+static void test_bitmap_row_cache(GTestStats* stats) {
+    std::vector<GPixel> storage;
+    auto bitmap = random_bitmap(12, 9, &storage);
+    //* magnified vertically, so consecutive rows can reuse the last one shaded
+    auto local = GMatrix::Translate(1.5f, 2) * GMatrix::Scale(3, 4.5f);
+    auto shader = GCreateBitmapShader(bitmap, local, GTileMode::kMirror);
+
+    //* a shader made and put into the same contexts for each row has nothing cached to reuse
+    const GMatrix contexts[] = {GMatrix(), GMatrix::Translate(3, 0), GMatrix::Translate(-3, 0.25f)};
+    bool same = true;
+    for (int c = 0; c < 3; ++c) {
+        shader->setContext(contexts[c]);
+        // starting where the last context left off, then on rows sharing a source row or not
+        for (int y : {22, 0, 1, 2, 3, 3, 7, 6, 20, 21, 22}) {
+            int x = y % 3 == 1 ? 5 : 0;
+            GPixel cached[30], fresh[30];
+            shader->shadeRow(x, y, 30, cached);
+            auto uncached = GCreateBitmapShader(bitmap, local, GTileMode::kMirror);
+            for (int k = 0; k <= c; ++k) {
+                uncached->setContext(contexts[k]);
+            }
+            uncached->shadeRow(x, y, 30, fresh);
+            same &= std::equal(cached, cached + 30, fresh);
+        }
+    }
+    EXPECT_TRUE(stats, same);
+
+    //* draws sharing the shader, with ctms that only move it sideways (and the same rows of
+    //* the device, all from one source row), each draw the same pixels as a new shader would
+    const GMatrix ctms[] = {GMatrix::Translate(2, 0), GMatrix::Translate(5, 0), GMatrix()};
+    std::vector<GPixel> shared(40 * 40), alone(40 * 40);
+    GBitmap sharedBM(40, 40, 40 * 4, shared.data(), false);
+    GBitmap aloneBM(40, 40, 40 * 4, alone.data(), false);
+    auto sharedShader = GCreateBitmapShader(bitmap, local, GTileMode::kRepeat);
+    same = true;
+    for (const auto& ctm : ctms) {
+        std::fill(shared.begin(), shared.end(), 0);
+        std::fill(alone.begin(), alone.end(), 0);
+        auto c0 = GCreateCanvas(sharedBM), c1 = GCreateCanvas(aloneBM);
+        c0->concat(ctm);
+        c1->concat(ctm);
+        c0->drawRect(GRect::LTRB(-10, 0, 60, 3), GPaint(sharedShader));
+        c1->drawRect(GRect::LTRB(-10, 0, 60, 3),
+                     GPaint(GCreateBitmapShader(bitmap, local, GTileMode::kRepeat)));
+        same &= shared == alone;
+    }
+    EXPECT_TRUE(stats, same);
+}
+
+static void test_bitmap_tiled_copy(GTestStats* stats) {
+    //* big enough to be sampled from the tiled copy when rotated, and not a multiple of the
+    //* 8x8 tiles, so the last row and column of tiles are partly empty
+    std::vector<GPixel> storage;
+    auto bitmap = random_bitmap(301, 267, &storage);
+    auto local = GMatrix::Translate(10, -20) * GMatrix::Scale(0.9f, 1.1f);
+    auto ctm = GMatrix::Translate(150, 20) * GMatrix::Rotate(0.7f);
+    auto shader = GCreateBitmapShader(bitmap, local);
+    shader->setContext(ctm);
+
+    //* the same pixels as reading the row-major bitmap, stepping as shadeRow does
+    auto m = *local.invert() * *ctm.invert();
+    auto clamp = [](double v, int size) {
+        return v < 0 ? 0 : v >= size ? size - 1 : GFloorToInt(static_cast<float>(v));
+    };
+    bool same = true;
+    const int w = 320;
+    for (int y = -5; y < 340; y += 3) {
+        GPixel row[w];
+        shader->shadeRow(-10, y, w, row);
+        auto px = m[0] * (-10 + 0.5) + m[2] * (y + 0.5) + m[4];
+        auto py = m[1] * (-10 + 0.5) + m[3] * (y + 0.5) + m[5];
+        for (int i = 0; i < w; ++i) {
+            same &= row[i] == *bitmap.getAddr(clamp(px, 301), clamp(py, 267));
+            px += m[0];
+            py += m[1];
+        }
+    }
+    EXPECT_TRUE(stats, same);
+}
+
+static void test_matrix_map_points(GTestStats* stats) {
+    //* one matrix for every combination of the type bits
+    const GMatrix matrices[] = {
+        GMatrix(),
+        GMatrix::Translate(3.5f, -2.25f),
+        GMatrix::Scale(1.5f, -0.75f),
+        GMatrix::Translate(3.5f, -2.25f) * GMatrix::Scale(1.5f, -0.75f),
+        GMatrix(1, 0.3f, 0, -0.2f, 1, 0),
+        GMatrix(1, 0.3f, 4, -0.2f, 1, -7),
+        GMatrix::Rotate(0.7f) * GMatrix::Scale(2, 3),
+        GMatrix::Translate(-1, 9) * GMatrix::Rotate(-2.1f) * GMatrix::Scale(0.5f, 1.25f),
+    };
+    GRandom rand;
+    GPoint src[9];
+    for (auto& p : src) {
+        p = {rand.nextF() * 200 - 100, rand.nextF() * 200 - 100};
+    }
+    unsigned types = 0;
+    bool same = true;
+    for (const auto& m : matrices) {
+        types |= 1u << m.getType();
+        //* counts that leave 1 to 3 points after the 4 at a time loop, or only those
+        for (int count : {1, 3, 5, 7, 9}) {
+            GPoint expected[9], dst[9], inPlace[9];
+            for (int i = 0; i < count; ++i) {
+                expected[i] = {m[0] * src[i].x + m[2] * src[i].y + m[4],
+                               m[1] * src[i].x + m[3] * src[i].y + m[5]};
+            }
+            m.mapPoints(dst, src, count);
+            std::copy(src, src + count, inPlace);
+            m.mapPoints(inPlace, count);
+            for (int i = 0; i < count; ++i) {
+                same &= dst[i] == expected[i] && inPlace[i] == expected[i];
+            }
+        }
+    }
+    EXPECT_EQ(stats, types, 0xFFu);
+    EXPECT_TRUE(stats, same);
+}
+
+static void test_span_merging(GTestStats* stats) {
+    const int w = 40, h = 24;
+    auto rects_path = [](std::initializer_list<GRect> rects) {
+        GPathBuilder bu;
+        for (const auto& r : rects) {
+            bu.addRect(r);
+        }
+        return bu.detach();
+    };
+    struct {
+        std::shared_ptr<GPath> merged;               // contours whose spans touch or overlap
+        std::vector<std::shared_ptr<GPath>> apart;   // the same pixels, drawn one by one
+    } cases[] = {
+        //* touching spans, and spans a pixel apart: each pixel is blended once either way
+        { rects_path({GRect::LTRB(2, 2, 10, 20), GRect::LTRB(11, 4, 21, 18)}),
+          {rects_path({GRect::LTRB(2, 2, 10, 20)}), rects_path({GRect::LTRB(11, 4, 21, 18)})} },
+        { rects_path({GRect::LTRB(2, 2, 10, 20), GRect::LTRB(10, 4, 21, 18)}),
+          {rects_path({GRect::LTRB(2, 2, 10, 20)}), rects_path({GRect::LTRB(10, 4, 21, 18)})} },
+        { rects_path({GRect::LTRB(1, 1, 4, 9), GRect::LTRB(4, 1, 7, 9), GRect::LTRB(7, 1, 10, 9),
+                      GRect::LTRB(10, 1, 13, 9)}),
+          {rects_path({GRect::LTRB(1, 1, 13, 9)})} },
+        //* overlapping spans, and spans clamped to the same right edge: blended once, as the
+        //* union of the contours
+        { rects_path({GRect::LTRB(5, 3, 20, 12), GRect::LTRB(12, 6, 30, 15)}),
+          {rects_path({GRect::LTRB(5, 3, 20, 6)}), rects_path({GRect::LTRB(5, 6, 30, 12)}),
+           rects_path({GRect::LTRB(12, 12, 30, 15)})} },
+        { rects_path({GRect::LTRB(30, 5, 50, 20), GRect::LTRB(36, 8, 70, 22)}),
+          {rects_path({GRect::LTRB(30, 5, 40, 8)}), rects_path({GRect::LTRB(30, 8, 40, 20)}),
+           rects_path({GRect::LTRB(36, 20, 40, 22)})} },
+    };
+    auto shader = [] {
+        return GCreateLinearGradient({0, 0}, {40, 10}, {1, 0, 0, 0.25f}, {0, 1, 1, 1},
+                                     GTileMode::kMirror);
+    };
+    bool same = true;
+    for (const auto& c : cases) {
+        for (auto mode : {GBlendMode::kSrcOver, GBlendMode::kXor, GBlendMode::kSrc}) {
+            for (bool shaded : {false, true}) {
+                GPixel merged[w * h], apart[w * h];
+                GBitmap mergedBM(w, h, w * 4, merged, false), apartBM(w, h, w * 4, apart, false);
+                auto c0 = GCreateCanvas(mergedBM), c1 = GCreateCanvas(apartBM);
+                c0->clear({0.2f, 0.4f, 0.6f, 0.5f});
+                c1->clear({0.2f, 0.4f, 0.6f, 0.5f});
+                GPaint paint({0.9f, 0.5f, 0.1f, 0.6f});
+                if (shaded) {
+                    paint.setShader(shader());
+                }
+                paint.setBlendMode(mode);
+                c0->drawPath(*c.merged, paint);
+                for (const auto& path : c.apart) {
+                    c1->drawPath(*path, paint);
+                }
+                same &= std::equal(merged, merged + w * h, apart);
+            }
+        }
+    }
+    EXPECT_TRUE(stats, same);
+}
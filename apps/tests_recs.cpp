@@ -14,6 +14,7 @@
 #include "tests_pa3.cpp"
 #include "tests_pa4.cpp"
 #include "tests_pa5.cpp"
+#include "tests_pa6.cpp"
 
 const GTestRec gTestRecs[] = {
     { test_clear,       "clear"         },
@@ -39,6 +40,39 @@ const GTestRec gTestRecs[] = {
     { test_path_chop_cubic,   "path_chop_cubic"    },
     { test_path_bounds, "path_bounds" },
 
+    { test_path_arena_derived, "path_arena_derived" },
+    { test_draw_rects_match_draw_rect, "draw_rects_match_draw_rect" },
+    { test_matrix_set_type, "matrix_set_type" },
+    { test_path_pack_round_trip, "path_pack_round_trip" },
+    { test_path_simplified, "path_simplified" },
+    { test_path_view, "path_view" },
+    { test_path_bounds_rotated_circle, "path_bounds_rotated_circle" },
+    { test_aa_coverage, "aa_coverage" },
+    { test_triangles_seams, "triangles_seams" },
+    { test_triangles_colors, "triangles_colors" },
+    { test_oval_containment, "oval_containment" },
+    { test_lines_aliased, "lines_aliased" },
+    { test_lines_antialiased, "lines_antialiased" },
+    { test_stroke_caps, "stroke_caps" },
+    { test_stroke_joins, "stroke_joins" },
+    { test_stroke_closed, "stroke_closed" },
+    { test_svg_relative, "svg_relative" },
+    { test_svg_reflection, "svg_reflection" },
+    { test_svg_arcs, "svg_arcs" },
+    { test_svg_implicit, "svg_implicit" },
+    { test_svg_numbers, "svg_numbers" },
+    { test_path_level_of_detail, "path_level_of_detail" },
+    { test_gradient_radial, "gradient_radial" },
+    { test_gradient_sweep, "gradient_sweep" },
+    { test_draw_paths_match_draw_path, "draw_paths_match_draw_path" },
+    { test_draw_rect_scaled, "draw_rect_scaled" },
+    { test_shader_fast_paths, "shader_fast_paths" },
+    { test_blend_pixels_row_runs, "blend_pixels_row_runs" },
+    { test_bitmap_row_cache, "bitmap_row_cache" },
+    { test_bitmap_tiled_copy, "bitmap_tiled_copy" },
+    { test_matrix_map_points, "matrix_map_points" },
+    { test_span_merging, "span_merging" },
+
     { nullptr, nullptr },
 };
 
@@ -7,6 +7,7 @@
 
 #include "GMatrix.h"
 #include "GPaint.h"
+#include "GPathBuilder.h"
 #include <string>
 
 class GBitmap;
@@ -58,6 +59,28 @@ public:
      */
     virtual void drawRect(const GRect&, const GPaint&) = 0;
 
+    /**
+     *  Fill each of the [count] rectangles with the paint, as if drawRect() was called on each
+     *  of them in order (following the same "containment" rule).
+     */
+    virtual void drawRects(const GRect rects[], int count, const GPaint& paint) {
+        for (int i = 0; i < count; ++i) {
+            this->drawRect(rects[i], paint);
+        }
+    }
+
+    /**
+     *  Same as drawRects(rects, count, paint), except rects[i] is filled with colors[i] in place
+     *  of the paint's color.
+     */
+    virtual void drawRects(const GRect rects[], const GColor colors[], int count,
+                           const GPaint& paint) {
+        GPaint p(paint);
+        for (int i = 0; i < count; ++i) {
+            this->drawRect(rects[i], p.setColor(colors[i]));
+        }
+    }
+
     /**
      *  Fill the convex polygon with the color and blendmode,
      *  following the same "containment" rule as rectangles.
@@ -69,6 +92,93 @@ public:
      */
     virtual void drawPath(const GPath&, const GPaint&) = 0;
 
+    /**
+     *  Stroke the path with the paint: fill the area within stroke.width/2 of its contours,
+     *  with the stroke's joins and caps (see GPathBuilder::addStroke).
+     *
+     *  The default fills the stroke's geometry as a path.
+     */
+    virtual void strokePath(const GPath& path, const GStroke& stroke, const GPaint& paint) {
+        GPathBuilder bu;
+        bu.addStroke(path, stroke);
+        this->drawPath(*bu.detach(), paint);
+    }
+
+    /**
+     *  Fill the oval (ellipse) inscribed in the rectangle with the paint, following the same
+     *  "containment" rule as rectangles.
+     *
+     *  The default draws it as a path (see GPathBuilder::addCircle).
+     */
+    virtual void drawOval(const GRect& rect, const GPaint& paint) {
+        GPathBuilder bu;
+        bu.addCircle({0, 0}, 1);
+        bu.transform(GMatrix::Translate((rect.left + rect.right) * 0.5f,
+                                        (rect.top + rect.bottom) * 0.5f) *
+                     GMatrix::Scale(rect.width() * 0.5f, rect.height() * 0.5f));
+        this->drawPath(*bu.detach(), paint);
+    }
+
+    /**
+     *  Stroke the polyline connecting pts[0], pts[1], ... pts[count-1] with a hairline: a line
+     *  one device pixel wide, whatever the CTM's scale. Without anti-aliasing each segment touches
+     *  one pixel per row or column (whichever it crosses more of); with it, the segment's coverage
+     *  is split between the two pixels nearest the line.
+     *
+     *  The default fills a quad one unit wide around each segment (so its width follows the CTM).
+     */
+    virtual void drawLines(const GPoint pts[], int count, const GPaint& paint) {
+        for (int i = 0; i + 1 < count; ++i) {
+            GPoint p0 = pts[i];
+            GPoint p1 = pts[i + 1];
+            GVector norm = {p1.y - p0.y, p0.x - p1.x};
+            float len = norm.length();
+            if (len == 0) {
+                continue;
+            }
+            norm = norm * (0.5f / len);
+            GPoint quad[4] = {p0 + norm, p1 + norm, p1 - norm, p0 - norm};
+            this->drawConvexPolygon(quad, 4, paint);
+        }
+    }
+
+    /**
+     *  Fill paths[i] with paints[i] for each of the [count] paths, with the same result as
+     *  calling drawPath() on each of them in order.
+     */
+    virtual void drawPaths(const GPath* const paths[], const GPaint paints[], int count) {
+        for (int i = 0; i < count; ++i) {
+            this->drawPath(*paths[i], paints[i]);
+        }
+    }
+
+    /**
+     *  Fill [triCount] triangles, whose corners are verts[indices[3*i + 0..2]] (or verts[3*i + 0..2]
+     *  if indices is null), following the same "containment" rule as rectangles.
+     *
+     *  If colors is not null, it holds one color per vertex (indexed like verts), and each pixel's
+     *  color is interpolated from the corners of its triangle in place of the paint's color. If the
+     *  paint also has a shader, the shader's colors are modulated by the interpolated colors.
+     *
+     *  The default fills each triangle with the average of its corners' colors.
+     */
+    virtual void drawTriangles(const GPoint verts[], const GColor colors[], const int indices[],
+                               int triCount, const GPaint& paint) {
+        GPaint p(paint);
+        for (int i = 0; i < triCount; ++i) {
+            int n[3];
+            GPoint pts[3];
+            for (int k = 0; k < 3; ++k) {
+                n[k] = indices ? indices[3 * i + k] : 3 * i + k;
+                pts[k] = verts[n[k]];
+            }
+            if (colors) {
+                p.setColor((colors[n[0]] + colors[n[1]] + colors[n[2]]) * (1.0f / 3));
+            }
+            this->drawConvexPolygon(pts, 3, p);
+        }
+    }
+
     // Helpers
 
     void translate(float x, float y) {
@@ -91,6 +201,11 @@ public:
     void fillRect(const GRect& rect, const GColor& color) {
         this->drawRect(rect, GPaint(color));
     }
+
+    void drawLine(GPoint p0, GPoint p1, const GPaint& paint) {
+        const GPoint pts[] = {p0, p1};
+        this->drawLines(pts, 2, paint);
+    }
 };
 
 /**
@@ -36,11 +36,35 @@ public:
         assert(index >= 0 && index < 6);
         return fMat[index];
     }
-    float& operator[](int index) {
+    // Writes go through set(), so reads never discard the cached type (see getType())
+    void set(int index, float value) {
         assert(index >= 0 && index < 6);
-        return fMat[index];
+        fMat[index] = value;
+        fTypeMask = kUnknown_Mask;
+    }
+
+    enum TypeMask {
+        kIdentity_Mask  = 0,
+        kTranslate_Mask = 1 << 0,   // e or f is not 0
+        kScale_Mask     = 1 << 1,   // a or d is not 1
+        kAffine_Mask    = 1 << 2,   // b or c is not 0
+    };
+
+    /**
+     *  Return the TypeMask bits of the parts of this matrix that differ from the identity.
+     *  It is computed on first use, and cached until set() changes the matrix.
+     */
+    unsigned getType() const {
+        if (fTypeMask & kUnknown_Mask) {
+            fTypeMask = this->computeType();
+        }
+        return fTypeMask;
     }
 
+    bool isIdentity() const { return this->getType() == kIdentity_Mask; }
+    bool isTranslate() const { return !(this->getType() & ~kTranslate_Mask); }
+    bool isScaleTranslate() const { return !(this->getType() & kAffine_Mask); }
+
     bool operator==(const GMatrix& m) {
         for (int i = 0; i < 6; ++i) {
             if (fMat[i] != m.fMat[i]) {
@@ -102,7 +126,12 @@ public:
     }
 
 private:
+    static constexpr unsigned kUnknown_Mask = 1 << 7;
+
     float fMat[6];
+    mutable unsigned fTypeMask = kUnknown_Mask;
+
+    unsigned computeType() const;
 };
 
 #endif
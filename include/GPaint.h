@@ -31,6 +31,10 @@ public:
     GBlendMode getBlendMode() const { return fMode; }
     GPaint&    setBlendMode(GBlendMode m) { fMode = m; return *this; }
 
+    // When set, geometry edges are antialiased (partial coverage) instead of all-or-nothing.
+    bool    isAntiAlias() const { return fAntiAlias; }
+    GPaint& setAntiAlias(bool aa) { fAntiAlias = aa; return *this; }
+
     GShader* peekShader() const { return fShader.get(); }
     std::shared_ptr<GShader> shareShader() const { return fShader; }
     GPaint&  setShader(std::shared_ptr<GShader> s) { fShader = s; return *this; }
@@ -39,6 +43,7 @@ private:
     GColor                      fColor = {0, 0, 0, 1};
     std::shared_ptr<GShader>    fShader;
     GBlendMode                  fMode = GBlendMode::kSrcOver;
+    bool                        fAntiAlias = false;
 };
 
 #endif
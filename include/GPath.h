@@ -5,9 +5,12 @@
 #include "GPoint.h"
 #include "GRect.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 
-enum GPathVerb {
+enum GPathVerb : uint8_t {
     kMove,  // returns pts[0] from Iter
     kLine,  // returns pts[0]..pts[1] from Iter and Edger
     kQuad,  // returns pts[0]..pts[2] from Iter and Edger
@@ -28,7 +31,18 @@ public:
      */
     GRect bounds() const;
 
-    size_t countPoints() const { return fPts.size(); }
+    size_t countPoints() const { return fQuantPts.empty() ? fData.ptCount : fQuantPts.size() / 2; }
+
+    /**
+     *  Returns true if the path is a single oval contour (e.g. only an addCircle() was made on
+     *  its builder), and if so, stores the oval's bounds in oval (if it is not null).
+     */
+    bool isOval(GRect* oval) const {
+        if (fIsOval && oval) {
+            *oval = fOval;
+        }
+        return fIsOval;
+    }
 
     /**
      *  Create a new path by transforming the points in this path.
@@ -39,6 +53,41 @@ public:
         return this->transform(GMatrix::Translate(dx, dy));
     }
 
+    /**
+     *  Return a copy of this path that stores its points as 16-bit fixed point within the bounds
+     *  of its control points (4 bytes per point instead of 8), for large static data. The points
+     *  read back, e.g. by Iter and Edger, are within 1/131070 of the bounds' size of the originals.
+     *
+     *  If the path is empty, already quantized, or has non-finite points, returns this path.
+     */
+    std::shared_ptr<GPath> quantized() const;
+
+    bool isQuantized() const { return !fQuantPts.empty(); }
+
+    /**
+     *  Return a copy of this path without what does not change the area it covers: repeated
+     *  points, points in the middle of a straight run of lines, contours with no area, and quads
+     *  and cubics whose control points lie (in order) on their chord, which become lines.
+     *
+     *  Points must line up exactly to be dropped. If nothing is dropped, returns this path.
+     *  The geometry is the same, but not always the pixels: a curve that became a line, or lines
+     *  that were merged, give edges that round (and so may land on pixel centers) differently.
+     */
+    std::shared_ptr<GPath> simplified() const;
+
+    // the tolerances of the levels of detail that levelOfDetail() picks from, finest first
+    static constexpr int kLODLevels = 3;
+    static constexpr float kLODTolerances[kLODLevels] = {0.25f, 1, 4};
+
+    /**
+     *  Return the coarsest level of detail of this path whose contours stay within tolerance of
+     *  this path's, or this path if there is none worth drawing instead (with at most half the
+     *  points). A level flattens the curves into lines, then drops the points that the lines can
+     *  do without (Douglas-Peucker). The levels are built together the first time one is asked
+     *  for (safely, if several threads ask at once), then kept.
+     */
+    const GPath& levelOfDetail(float tolerance) const;
+
     // maximum number of points returned by Iter::next() and Edger::next()
     enum {
         kMaxNextPoints = 4
@@ -57,7 +106,8 @@ public:
         nonstd::optional<GPathVerb> next(GPoint pts[]);
 
     private:
-        const GPoint*    fCurrPt;
+        const GPath*     fPath;
+        size_t           fCurrPt;
         const GPathVerb* fCurrVb;
         const GPathVerb* fStopVb;
     };
@@ -89,8 +139,9 @@ public:
         nonstd::optional<GPathVerb> next(GPoint pts[]);
 
     private:
-        const GPoint*    fPrevMove;
-        const GPoint*    fCurrPt;
+        const GPath*     fPath;
+        size_t           fPrevMove;
+        size_t           fCurrPt;
         const GPathVerb* fCurrVb;
         const GPathVerb* fStopVb;
         int fPrevVerb;
@@ -112,16 +163,83 @@ public:
      */
     static void ChopCubicAt(const GPoint src[4], GPoint dst[7], float t);
 
-    GPath(std::vector<GPoint> pts, std::vector<GPathVerb> vbs)
-        : fPts(std::move(pts))
-        , fVbs(std::move(vbs))
-    {}
+    GPath(std::vector<GPoint> pts, std::vector<GPathVerb> vbs);
+
+    /**
+     *  Return a path that reads its points and verbs in place (e.g. from the static arrays of a
+     *  GStaticPathBuilder), without copying or owning them. The arrays must outlive the path, and
+     *  the path (which need not be owned by a shared_ptr) must outlive the paths made from it
+     *  (e.g. by transform), so this is meant for static data.
+     */
+    static GPath View(const GPoint pts[], size_t ptCount, const GPathVerb vbs[], size_t vbCount);
+
+private:
+    struct Storage;
+
+    // a passkey: only GPath and its friends can make one, and so call the constructor below
+    class Key {
+        Key() {}
+        friend class GPath;
+        friend class GPathBuilder;
+        friend class GPathPack;
+    };
+
+public:
+    // public so std::make_shared and std::allocate_shared can call it, given a Key
+    GPath(Key, const Storage&);
 
 private:
     friend class GPathBuilder;
+    friend class GPathPack;
+
+    // where a path's points and verbs live, and what keeps them alive: an owner is null if they
+    // live in the same allocation as the path itself (see GPathBuilder::detach(GPathArena*))
+    struct Storage {
+        std::shared_ptr<const void> ptsOwner;
+        std::shared_ptr<const void> vbsOwner;
+        const GPoint*    pts = nullptr;
+        size_t           ptCount = 0;
+        const GPathVerb* vbs = nullptr;
+        size_t           vbCount = 0;
+    };
 
-    const std::vector<GPoint>    fPts;
-    const std::vector<GPathVerb> fVbs;
+    // immutable, so paths made from this one (e.g. by transform) share them instead of copying
+    Storage fData;  // no points if the path is quantized
+
+    // point the other path's storage at our verbs, and an owner keeping them alive (a copy, if
+    // they live in our own allocation)
+    void shareVerbs(Storage*) const;
+
+    // this path, as returned when a method has nothing to change: shared_from_this(), or if no
+    // shared_ptr owns this path (e.g. a View()), a pointer to it that owns nothing, or if its
+    // points and verbs are in its own allocation (e.g. from an arena), a copy
+    std::shared_ptr<GPath> self() const;
+
+    // if the path is quantized, its points as (x, y) pairs: point = fQuantOrigin + q * fQuantScale
+    std::vector<uint16_t> fQuantPts;
+    GPoint fQuantOrigin = {0, 0};
+    GPoint fQuantScale = {0, 0};
+
+    bool  fIsOval = false;
+    GRect fOval = {0, 0, 0, 0};
+
+    // levelOfDetail()'s levels, null if they have over half the points of this path, made under
+    // once (so this path stays safe to share between threads), and only if they are used. Held
+    // by a shared_ptr, set on first use, so paths stay copyable (a copy shares the levels, as it
+    // has the same points) and cost no allocation until then.
+    struct LevelsOfDetail {
+        std::once_flag once;
+        std::shared_ptr<GPath> levels[kLODLevels];
+    };
+    mutable std::shared_ptr<LevelsOfDetail> fLODs;
+
+    GPoint point(size_t index) const {
+        if (fQuantPts.empty()) {
+            return fData.pts[index];
+        }
+        return {fQuantOrigin.x + fQuantPts[2 * index] * fQuantScale.x,
+                fQuantOrigin.y + fQuantPts[2 * index + 1] * fQuantScale.y};
+    }
 };
 
 #endif
@@ -5,9 +5,61 @@
 #include "GRect.h"
 #include "GPath.h"
 
+#include <memory>
 #include <optional>
 #include <vector>
 
+enum class GStrokeJoin {
+    kMiter, // extend the outer edges until they meet (or bevel, past the miter limit)
+    kRound, // round the corner with a circle of the stroke's width
+    kBevel, // connect the outer edges with a line
+};
+
+enum class GStrokeCap {
+    kButt,   // end exactly at the end point
+    kRound,  // end with a half circle around the end point
+    kSquare, // extend past the end point by half the width
+};
+
+struct GStroke {
+    float       width = 1;
+    GStrokeJoin join = GStrokeJoin::kMiter;
+    GStrokeCap  cap = GStrokeCap::kButt;
+    // longest miter, as a multiple of half the width, before the join falls back to kBevel
+    float       miterLimit = 4;
+    // stroke every contour of 3 or more points as closed, as it is filled (e.g. addRect's)
+    bool        closed = false;
+};
+
+/**
+ *  Memory for paths that are built and dropped together (e.g. each frame), handed out from large
+ *  blocks so that detaching a path into it (see GPathBuilder::detach(GPathArena*)) is a pointer
+ *  bump instead of a trip to the heap. reset() recycles the blocks, so the paths detached into the
+ *  arena must not be used after it (or after the arena is destroyed).
+ */
+class GPathArena {
+public:
+    explicit GPathArena(size_t blockSize = 64 * 1024) : fBlockSize(blockSize) {}
+    GPathArena(const GPathArena&) = delete;
+    GPathArena& operator=(const GPathArena&) = delete;
+
+    void* allocate(size_t size, size_t align);
+
+    // Release everything allocated so far, keeping the blocks for reuse.
+    void reset();
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> mem;
+        size_t size;
+    };
+    std::vector<Block> fBlocks;
+    size_t fBlockSize;
+    size_t fNextBlock = 0;  // the block after the one we are allocating from
+    char*  fCurr = nullptr;
+    char*  fEnd = nullptr;
+};
+
 class GPathBuilder {
 public:
     GPathBuilder() {}
@@ -17,6 +69,20 @@ public:
      */
     void reset();
 
+    /**
+     *  Make room for this many more points and verbs, so that building a path of a known size
+     *  does not regrow the storage along the way.
+     */
+    void reserve(int points, int verbs);
+
+    /**
+     *  If keep is true, detach() behaves like detach(nullptr): it copies the path out and keeps
+     *  this builder's storage, so a builder making many paths stops reallocating once it has grown
+     *  to fit the largest. Otherwise (the default), detach() hands its storage to the path, which
+     *  is cheaper for a one-off path.
+     */
+    void setKeepCapacity(bool keep) { fKeepCapacity = keep; }
+
     /**
      *  Start a new contour at the specified coordinate.
      *  Returns a reference to this path.
@@ -68,6 +134,18 @@ public:
      */
     void addCircle(GPoint center, float radius, GPathDirection = GPathDirection::kCW);
 
+    /**
+     *  Append the fill geometry of stroking each contour of the path: the area within width/2
+     *  of its segments, plus its joins and caps. A contour whose last point equals its first is
+     *  closed, and gets a join there instead of caps; with GStroke::closed every contour (of 3
+     *  or more points) is, with a segment back to its first point, like the fill of the path.
+     *  Curves (and round joins and caps) are approximated by lines to within tolerance.
+     *
+     *  The geometry is made of convex contours that all wind the same way, so it should be filled
+     *  with the default (non-zero winding) rule.
+     */
+    void addStroke(const GPath&, const GStroke&, float tolerance = 0.25f);
+
     void transform(const GMatrix&);
 
     /**
@@ -76,9 +154,26 @@ public:
      */
     std::shared_ptr<GPath> detach();
 
+    /**
+     *  Like detach(), but the path is copied out, together with its points and verbs, into one
+     *  allocation from the arena (or from the heap, if arena is null), and this builder keeps its
+     *  storage for the next path. The path must not be used after the arena is reset, but the
+     *  paths made from it (e.g. by transform()) copy what they would share, so they may be.
+     */
+    std::shared_ptr<GPath> detach(GPathArena* arena);
+
 private:
     std::vector<GPoint>    fPts;
     std::vector<GPathVerb> fVbs;
+
+    // if the path so far is just one addCircle() (or its transform), fVbs.size() and its bounds
+    size_t fOvalVerbs = 0;
+    GRect  fOval = {0, 0, 0, 0};
+
+    bool fKeepCapacity = false;
+
+    // finish detaching the path, marking it as an oval if it is one, and reset()
+    std::shared_ptr<GPath> finish(std::shared_ptr<GPath>);
 };
 
 #endif
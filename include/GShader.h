@@ -38,6 +38,26 @@ public:
      *  can hold at least [count] entries.
      */
     virtual void shadeRow(int x, int y, int count, GPixel row[]) = 0;
+
+    /**
+     *  Capability queries, valid after setContext(). They let the canvas pick a cheaper blitter
+     *  than calling shadeRow() for every pixel. The defaults make no promises.
+     */
+
+    // If every pixel returned by shadeRow() is the same, return that (premul) pixel.
+    virtual nonstd::optional<GPixel> asConstantColor() { return {}; }
+
+    /**
+     *  If device pixel (x, y) shades to exactly bitmap pixel (x + dx, y + dy) (e.g. an
+     *  identity or integer-translate clamped bitmap), return true and fill out the params.
+     */
+    virtual bool asAffineBitmap(GBitmap* bitmap, int* dx, int* dy) { return false; }
+
+    // Return true iff every pixel in a given row shades to the same value.
+    virtual bool isRowConstant() { return false; }
+
+    // Return true iff every pixel in a given column shades to the same value.
+    virtual bool isColumnConstant() { return false; }
 };
 
 /**
@@ -68,4 +88,25 @@ static inline std::shared_ptr<GShader> GCreateLinearGradient(GPoint p0, GPoint p
     return GCreateLinearGradient(p0, p1, colors, 2, mode);
 }
 
+/**
+ *  Return a subclass of GShader that draws a radial gradient of [count] colors. Color[0] is at
+ *  the center, Color[count-1] is at [radius] from it, and the rest are evenly spaced between.
+ *  Colors are handled like GCreateLinearGradient (unpremul in, premul out).
+ *
+ *  If count < 1 or radius <= 0, this returns nullptr.
+ */
+std::shared_ptr<GShader> GCreateRadialGradient(GPoint center, float radius, const GColor[],
+                                               int count, GTileMode = GTileMode::kClamp);
+
+/**
+ *  Return a subclass of GShader that sweeps [count] colors once around the center, clockwise
+ *  (in device space) starting at the angle [startRadians] from the x-axis. The colors cover
+ *  every angle exactly once, so unlike the other gradients there is no GTileMode (it would
+ *  always act as kClamp).
+ *
+ *  If count < 1, this returns nullptr.
+ */
+std::shared_ptr<GShader> GCreateSweepGradient(GPoint center, float startRadians,
+                                              const GColor[], int count);
+
 #endif
@@ -4,10 +4,13 @@
 
 #include "../include/GPathBuilder.h"
 #include "../include/GMatrix.h"
+#include <algorithm>
+#include <cmath>
 
 void GPathBuilder::reset() {
     fPts.clear();
     fVbs.clear();
+    fOvalVerbs = 0;
 }
 
 void GPathBuilder::moveTo(GPoint p) {
@@ -37,35 +40,251 @@ void GPathBuilder::cubicTo(GPoint p1, GPoint p2, GPoint p3) {
 }
 
 void GPathBuilder::transform(const GMatrix& m) {
+    if (m.isIdentity()) {
+        return;
+    }
     m.mapPoints(fPts.data(), fPts.size());
+    // scales and translates keep an oval an (axis-aligned) oval
+    if (fOvalVerbs && m.isScaleTranslate()) {
+        GPoint corners[2] = {{fOval.left, fOval.top}, {fOval.right, fOval.bottom}};
+        m.mapPoints(corners, 2);
+        fOval = GRect::LTRB(std::min(corners[0].x, corners[1].x),
+                            std::min(corners[0].y, corners[1].y),
+                            std::max(corners[0].x, corners[1].x),
+                            std::max(corners[0].y, corners[1].y));
+    } else {
+        fOvalVerbs = 0;
+    }
+}
+
+void GPathBuilder::reserve(int points, int verbs) {
+    fPts.reserve(fPts.size() + std::max(points, 0));
+    fVbs.reserve(fVbs.size() + std::max(verbs, 0));
 }
 
 std::shared_ptr<GPath> GPathBuilder::detach() {
-    auto path = std::make_shared<GPath>(std::move(fPts), std::move(fVbs));
+    if (fKeepCapacity) {
+        return this->detach(nullptr);
+    }
+    //* hand our storage to the path
+    return this->finish(std::make_shared<GPath>(std::move(fPts), std::move(fVbs)));
+}
+
+/**
+ *  Allocates a path's shared_ptr control block (which holds the path) with extra bytes after it,
+ *  from the arena if there is one (else the heap), and reports where the extra bytes start.
+ */
+template <typename T> struct PathAllocator {
+    using value_type = T;
+
+    PathAllocator(GPathArena* arena, size_t extra, char** extraStart)
+        : fArena(arena), fExtra(extra), fExtraStart(extraStart) {}
+    template <typename U> PathAllocator(const PathAllocator<U>& other)
+        : fArena(other.fArena), fExtra(other.fExtra), fExtraStart(other.fExtraStart) {}
+
+    T* allocate(size_t n) {
+        auto size = n * sizeof(T) + fExtra;
+        auto mem = static_cast<char*>(fArena ? fArena->allocate(size, alignof(T))
+                                             : ::operator new(size));
+        *fExtraStart = mem + n * sizeof(T);
+        return reinterpret_cast<T*>(mem);
+    }
+    void deallocate(T* ptr, size_t) {
+        if (!fArena) {
+            ::operator delete(ptr);
+        }
+    }
+
+    template <typename U> bool operator==(const PathAllocator<U>& other) const {
+        return fArena == other.fArena;
+    }
+    template <typename U> bool operator!=(const PathAllocator<U>& other) const {
+        return fArena != other.fArena;
+    }
+
+    GPathArena* fArena;
+    size_t      fExtra;
+    char**      fExtraStart;
+};
+
+std::shared_ptr<GPath> GPathBuilder::detach(GPathArena* arena) {
+    //* one allocation for the path, its points and its verbs, copied so we keep our storage
+    auto extra = alignof(GPoint) + fPts.size() * sizeof(GPoint) + fVbs.size() * sizeof(GPathVerb);
+    char* extraStart = nullptr;
+    auto path = std::allocate_shared<GPath>(PathAllocator<GPath>(arena, extra, &extraStart),
+                                            GPath::Key(), GPath::Storage());
+
+    auto align = reinterpret_cast<uintptr_t>(extraStart) % alignof(GPoint);
+    auto pts = reinterpret_cast<GPoint*>(extraStart + (align ? alignof(GPoint) - align : 0));
+    auto vbs = reinterpret_cast<GPathVerb*>(pts + fPts.size());
+    std::copy(fPts.begin(), fPts.end(), pts);
+    std::copy(fVbs.begin(), fVbs.end(), vbs);
+    path->fData.pts = pts;
+    path->fData.ptCount = fPts.size();
+    path->fData.vbs = vbs;
+    path->fData.vbCount = fVbs.size();
+    return this->finish(std::move(path));
+}
+
+std::shared_ptr<GPath> GPathBuilder::finish(std::shared_ptr<GPath> path) {
+    if (fOvalVerbs != 0 && fOvalVerbs == path->fData.vbCount) {
+        path->fIsOval = true;
+        path->fOval = fOval;
+    }
     this->reset();
     return path;
 }
 
+void* GPathArena::allocate(size_t size, size_t align) {
+    for (;;) {
+        auto curr = reinterpret_cast<uintptr_t>(fCurr);
+        auto start = (curr + align - 1) / align * align;
+        if (fCurr && start + size <= reinterpret_cast<uintptr_t>(fEnd)) {
+            fCurr = reinterpret_cast<char*>(start + size);
+            return reinterpret_cast<void*>(start);
+        }
+        //* on to the next block, reusing those from before the last reset() that are big enough
+        if (fNextBlock == fBlocks.size() || fBlocks[fNextBlock].size < size + align) {
+            auto blockSize = std::max(fBlockSize, size + align);
+            fBlocks.insert(fBlocks.begin() + fNextBlock,
+                           {std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+        }
+        fCurr = fBlocks[fNextBlock].mem.get();
+        fEnd = fCurr + fBlocks[fNextBlock].size;
+        fNextBlock += 1;
+    }
+}
+
+void GPathArena::reset() {
+    fNextBlock = 0;
+    fCurr = nullptr;
+    fEnd = nullptr;
+}
+
 /////////////////////////////////////////////////////////////
 
-static bool is_identity(const GMatrix& m) {
-    return m[0] == 1 && m[3] == 1 &&
-           m[1] == 0 && m[2] == 0 && m[4] == 0 && m[5] == 0;
+// make the vector shared, and point data and count at its contents
+template <typename T>
+static std::shared_ptr<const void> share(std::vector<T> vec, const T** data, size_t* count) {
+    auto owner = std::make_shared<const std::vector<T>>(std::move(vec));
+    *data = owner->data();
+    *count = owner->size();
+    return owner;
+}
+
+GPath::GPath(std::vector<GPoint> pts, std::vector<GPathVerb> vbs) {
+    fData.ptsOwner = share(std::move(pts), &fData.pts, &fData.ptCount);
+    fData.vbsOwner = share(std::move(vbs), &fData.vbs, &fData.vbCount);
+}
+
+GPath::GPath(Key, const Storage& data) : fData(data) {}
+
+GPath GPath::View(const GPoint pts[], size_t ptCount, const GPathVerb vbs[], size_t vbCount) {
+    //* owners that own nothing (so cost no allocation), but are non-null, so shareVerbs() and
+    //* the paths made from this one pass them on
+    Storage data;
+    data.ptsOwner = std::shared_ptr<const void>(std::shared_ptr<const void>(), pts);
+    data.vbsOwner = std::shared_ptr<const void>(std::shared_ptr<const void>(), vbs);
+    data.pts = pts;
+    data.ptCount = ptCount;
+    data.vbs = vbs;
+    data.vbCount = vbCount;
+    return GPath(Key(), data);
+}
+
+std::shared_ptr<GPath> GPath::self() const {
+    if (!fData.vbsOwner && fData.vbCount > 0) {
+        //* our points and verbs are in our own allocation (e.g. from an arena, which may be reset
+        //* while the returned path lives on), so it gets a copy of them
+        Storage data;
+        std::vector<GPoint> pts(fData.pts, fData.pts + fData.ptCount);
+        data.ptsOwner = share(std::move(pts), &data.pts, &data.ptCount);
+        this->shareVerbs(&data);
+        auto path = std::make_shared<GPath>(Key(), data);
+        path->fIsOval = fIsOval;
+        path->fOval = fOval;
+        return path;
+    }
+    auto path = const_cast<GPath*>(this)->weak_from_this().lock();
+    if (!path) {
+        path = std::shared_ptr<GPath>(std::shared_ptr<GPath>(), const_cast<GPath*>(this));
+    }
+    return path;
+}
+
+void GPath::shareVerbs(Storage* data) const {
+    if (fData.vbsOwner) {
+        data->vbsOwner = fData.vbsOwner;
+        data->vbs = fData.vbs;
+        data->vbCount = fData.vbCount;
+        return;
+    }
+    // our verbs are in our own allocation (e.g. from an arena, which may be reset while the other
+    // path lives on), so the other path gets a copy of them
+    std::vector<GPathVerb> vbs(fData.vbs, fData.vbs + fData.vbCount);
+    data->vbsOwner = share(std::move(vbs), &data->vbs, &data->vbCount);
 }
 
 std::shared_ptr<GPath> GPath::transform(const GMatrix& m) const {
-    if (fPts.empty() || is_identity(m)) {
-        return const_cast<GPath*>(this)->shared_from_this();
+    if (this->countPoints() == 0 || m.isIdentity()) {
+        return this->self();
     }
-    std::vector<GPoint> dst(fPts.size());
-    m.mapPoints(dst.data(), fPts.data(), fPts.size());
-    return std::make_shared<GPath>(std::move(dst), fVbs);
+    std::vector<GPoint> dst(this->countPoints());
+    if (this->isQuantized()) {
+        for (size_t i = 0; i < dst.size(); ++i) {
+            dst[i] = this->point(i);
+        }
+        m.mapPoints(dst.data(), dst.size());
+    } else {
+        m.mapPoints(dst.data(), fData.pts, fData.ptCount);
+    }
+    //* only the points change, the new path shares our verbs
+    Storage data;
+    data.ptsOwner = share(std::move(dst), &data.pts, &data.ptCount);
+    this->shareVerbs(&data);
+    return std::make_shared<GPath>(Key(), data);
+}
+
+std::shared_ptr<GPath> GPath::quantized() const {
+    auto self = this->self();
+    if (fData.ptCount == 0) {
+        return self;
+    }
+    const auto* pts = fData.pts;
+    GPoint lo = pts[0];
+    GPoint hi = pts[0];
+    for (size_t i = 0; i < fData.ptCount; ++i) {
+        auto p = pts[i];
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) {
+            return self;
+        }
+        lo = {std::min(lo.x, p.x), std::min(lo.y, p.y)};
+        hi = {std::max(hi.x, p.x), std::max(hi.y, p.y)};
+    }
+
+    Storage data;
+    this->shareVerbs(&data);
+    auto path = std::make_shared<GPath>(Key(), data);
+    path->fQuantOrigin = lo;
+    path->fQuantScale = {(hi.x - lo.x) / 65535, (hi.y - lo.y) / 65535};
+    path->fQuantPts.resize(2 * fData.ptCount);
+    auto quantize = [](float v, float lo, float scale) {
+        return static_cast<uint16_t>(scale > 0 ? std::min(65535.0f, (v - lo) / scale + 0.5f) : 0);
+    };
+    for (size_t i = 0; i < fData.ptCount; ++i) {
+        path->fQuantPts[2 * i] = quantize(pts[i].x, lo.x, path->fQuantScale.x);
+        path->fQuantPts[2 * i + 1] = quantize(pts[i].y, lo.y, path->fQuantScale.y);
+    }
+    path->fIsOval = fIsOval;
+    path->fOval = fOval;
+    return path;
 }
 
 GPath::Iter::Iter(const GPath& path) {
-    fCurrPt = path.fPts.data();
-    fCurrVb = path.fVbs.data();
-    fStopVb = fCurrVb + path.fVbs.size();
+    fPath = &path;
+    fCurrPt = 0;
+    fCurrVb = path.fData.vbs;
+    fStopVb = fCurrVb + path.fData.vbCount;
 }
 
 std::optional<GPathVerb> GPath::Iter::next(GPoint pts[]) {
@@ -76,22 +295,22 @@ std::optional<GPathVerb> GPath::Iter::next(GPoint pts[]) {
     GPathVerb v = *fCurrVb++;
     switch (v) {
         case kMove:
-            pts[0] = *fCurrPt++;
+            pts[0] = fPath->point(fCurrPt++);
             break;
         case kLine:
-            pts[0] = fCurrPt[-1];
-            pts[1] = *fCurrPt++;
+            pts[0] = fPath->point(fCurrPt - 1);
+            pts[1] = fPath->point(fCurrPt++);
             break;
         case kQuad:
-            pts[0] = fCurrPt[-1];
-            pts[1] = *fCurrPt++;
-            pts[2] = *fCurrPt++;
+            pts[0] = fPath->point(fCurrPt - 1);
+            pts[1] = fPath->point(fCurrPt++);
+            pts[2] = fPath->point(fCurrPt++);
             break;
         case kCubic:
-            pts[0] = fCurrPt[-1];
-            pts[1] = *fCurrPt++;
-            pts[2] = *fCurrPt++;
-            pts[3] = *fCurrPt++;
+            pts[0] = fPath->point(fCurrPt - 1);
+            pts[1] = fPath->point(fCurrPt++);
+            pts[2] = fPath->point(fCurrPt++);
+            pts[3] = fPath->point(fCurrPt++);
             break;
     }
     return v;
@@ -100,10 +319,11 @@ std::optional<GPathVerb> GPath::Iter::next(GPoint pts[]) {
 constexpr int kDoneVerb = -1;
 
 GPath::Edger::Edger(const GPath& path) {
-    fPrevMove = nullptr;
-    fCurrPt = path.fPts.data();
-    fCurrVb = path.fVbs.data();
-    fStopVb = fCurrVb + path.fVbs.size();
+    fPath = &path;
+    fPrevMove = 0;
+    fCurrPt = 0;
+    fCurrVb = path.fData.vbs;
+    fStopVb = fCurrVb + path.fData.vbCount;
     fPrevVerb = kDoneVerb;
 }
 
@@ -114,29 +334,29 @@ std::optional<GPathVerb> GPath::Edger::next(GPoint pts[]) {
         switch (*fCurrVb++) {
             case kMove:
                 if (fPrevVerb == kLine) {
-                    pts[0] = fCurrPt[-1];
-                    pts[1] = *fPrevMove;
+                    pts[0] = fPath->point(fCurrPt - 1);
+                    pts[1] = fPath->point(fPrevMove);
                     do_return = true;
                 }
                 fPrevMove = fCurrPt++;
                 fPrevVerb = kMove;
                 break;
             case kLine:
-                pts[0] = fCurrPt[-1];
-                pts[1] = *fCurrPt++;
+                pts[0] = fPath->point(fCurrPt - 1);
+                pts[1] = fPath->point(fCurrPt++);
                 fPrevVerb = kLine;
                 return kLine;
             case kQuad:
-                pts[0] = fCurrPt[-1];
-                pts[1] = *fCurrPt++;
-                pts[2] = *fCurrPt++;
+                pts[0] = fPath->point(fCurrPt - 1);
+                pts[1] = fPath->point(fCurrPt++);
+                pts[2] = fPath->point(fCurrPt++);
                 fPrevVerb = kQuad;
                 return kQuad;
             case kCubic:
-                pts[0] = fCurrPt[-1];
-                pts[1] = *fCurrPt++;
-                pts[2] = *fCurrPt++;
-                pts[3] = *fCurrPt++;
+                pts[0] = fPath->point(fCurrPt - 1);
+                pts[1] = fPath->point(fCurrPt++);
+                pts[2] = fPath->point(fCurrPt++);
+                pts[3] = fPath->point(fCurrPt++);
                 fPrevVerb = kCubic;
                 return kCubic;
         }
@@ -145,8 +365,8 @@ std::optional<GPathVerb> GPath::Edger::next(GPoint pts[]) {
         }
     }
     if (fPrevVerb >= kLine && fPrevVerb <= kCubic) {
-        pts[0] = fCurrPt[-1];
-        pts[1] = *fPrevMove;
+        pts[0] = fPath->point(fCurrPt - 1);
+        pts[1] = fPath->point(fPrevMove);
         fPrevVerb = kDoneVerb;
         return kLine;
     } else {
@@ -13,6 +13,10 @@
 #include <iostream>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 /** Helper Functions */
 inline unsigned int div255(unsigned int n) {
     return ((n + 128) * 257) >> 16;
@@ -113,86 +117,245 @@ const auto blendFuncs = std::vector<std::function<void(GPixel, GPixel*)>>{
     blendClear, blendSrc,    blendDst,    blendSrcOver, blendDstOver, blendSrcIn,
     blendDstIn, blendSrcOut, blendDstOut, blendSrcATop, blendDstATop, blendXor};
 
+// Simplify the blend mode when every src pixel is known to be opaque.
+inline GBlendMode reduce_mode_opaque(GBlendMode mode) {
+    switch (mode) {
+    case GBlendMode::kSrcOver:
+        return GBlendMode::kSrc;
+    case GBlendMode::kDstIn:
+        return GBlendMode::kDst;
+    case GBlendMode::kDstOut:
+        return GBlendMode::kClear;
+    case GBlendMode::kSrcATop:
+        return GBlendMode::kSrcIn;
+    case GBlendMode::kDstATop:
+        return GBlendMode::kDstOver;
+    default:
+        return mode;
+    }
+}
+
+// Simplify the blend mode when every src pixel is known to be transparent (zero).
+inline GBlendMode reduce_mode_transparent(GBlendMode mode) {
+    switch (mode) {
+    case GBlendMode::kSrc:
+    case GBlendMode::kSrcIn:
+    case GBlendMode::kDstIn:
+    case GBlendMode::kSrcOut:
+    case GBlendMode::kDstATop:
+        return GBlendMode::kClear;
+    case GBlendMode::kSrcOver:
+    case GBlendMode::kDstOver:
+    case GBlendMode::kDstOut:
+    case GBlendMode::kSrcATop:
+    case GBlendMode::kXor:
+        return GBlendMode::kDst;
+    default:
+        return mode;
+    }
+}
+
+// Blend a single (premul) src pixel into count dst pixels.
+inline void blend_color_row(GPixel* row_ptr, int count, GPixel src, GBlendMode mode) {
+    if (GPixel_GetA(src) == 255) {
+        mode = reduce_mode_opaque(mode);
+    } else if (GPixel_GetA(src) == 0) {
+        mode = reduce_mode_transparent(mode);
+    }
+    switch (mode) {
+    case GBlendMode::kDst:
+        return;
+    case GBlendMode::kClear:
+        src = 0;
+        [[fallthrough]];
+    case GBlendMode::kSrc:
+        for (auto i = 0; i < count; i++) {
+            row_ptr[i] = src;
+        }
+        return;
+    default:
+        break;
+    }
+    auto modeIdx = static_cast<int>(mode);
+    for (auto i = 0; i < count; i++) {
+        blendFuncs[modeIdx](src, &row_ptr[i]);
+    }
+}
+
+// Blend count already-shaded src pixels into dst, with no per-run mode simplification.
+inline void blend_run(GPixel* row_ptr, int count, const GPixel src[], GBlendMode mode) {
+    switch (mode) {
+    case GBlendMode::kDst:
+        return;
+    case GBlendMode::kClear:
+        std::fill(row_ptr, row_ptr + count, 0);
+        return;
+    case GBlendMode::kSrc:
+        std::copy(src, src + count, row_ptr);
+        return;
+    default:
+        break;
+    }
+    auto modeIdx = static_cast<int>(mode);
+    for (auto i = 0; i < count; i++) {
+        blendFuncs[modeIdx](src[i], &row_ptr[i]);
+    }
+}
+
+enum AlphaClass {
+    kTransparent_AlphaClass,
+    kPartial_AlphaClass,
+    kOpaque_AlphaClass,
+};
+
+inline AlphaClass alpha_class(GPixel p) {
+    auto a = GPixel_GetA(p);
+    return a == 0 ? kTransparent_AlphaClass : a == 255 ? kOpaque_AlphaClass : kPartial_AlphaClass;
+}
+
+// Return how many pixels, starting at src[0], share the alpha class of src[0].
+inline int alpha_run_length(const GPixel src[], int count) {
+    auto cls = alpha_class(src[0]);
+    int n = 1;
+#ifdef __SSE2__
+    //* compare the alpha bytes of 4 pixels at a time
+    const __m128i amask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i zero = _mm_setzero_si128();
+    for (; n + 4 <= count; n += 4) {
+        auto a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n)), amask);
+        int zeroBits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, zero)));
+        int fullBits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, amask)));
+        int bits = cls == kTransparent_AlphaClass ? zeroBits
+                   : cls == kOpaque_AlphaClass    ? fullBits
+                                                  : ~(zeroBits | fullBits) & 0xF;
+        if (bits != 0xF) {
+            return n + __builtin_ctz(~bits);
+        }
+    }
+#endif
+    while (n < count && alpha_class(src[n]) == cls) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ *  Blend count already-shaded src pixels into dst. The row is split into runs of transparent,
+ *  opaque and partial alpha, so that e.g. under SrcOver transparent runs never touch dst and
+ *  opaque runs are a straight copy. Only partial runs pay for the full blend.
+ */
+inline void blend_pixels_row(GPixel* row_ptr, int count, const GPixel src[], GBlendMode mode) {
+    switch (mode) {
+    case GBlendMode::kClear:
+    case GBlendMode::kSrc:
+    case GBlendMode::kDst:
+        blend_run(row_ptr, count, src, mode);
+        return;
+    default:
+        break;
+    }
+    for (auto i = 0; i < count;) {
+        auto n = alpha_run_length(src + i, count - i);
+        switch (alpha_class(src[i])) {
+        case kTransparent_AlphaClass:
+            blend_run(row_ptr + i, n, src + i, reduce_mode_transparent(mode));
+            break;
+        case kOpaque_AlphaClass:
+            blend_run(row_ptr + i, n, src + i, reduce_mode_opaque(mode));
+            break;
+        case kPartial_AlphaClass:
+            blend_run(row_ptr + i, n, src + i, mode);
+            break;
+        }
+        i += n;
+    }
+}
+
 inline void blend_row(int x, int y, int count, GPaint paint, GBitmap fDevice, GMatrix ctm) {
+    if (count <= 0)
+        return;
 
     auto row_ptr = fDevice.getAddr(x, y);
     auto mode = paint.getBlendMode();
-    if (paint.peekShader()) {
-        // std::cout << "shader" << std::endl;
-        auto shader = paint.shareShader();
-        // shader->setContext(ctm);
-        GPixel pixelsToFill[count];
-        shader->shadeRow(x, y, count, pixelsToFill);
-        if (shader->isOpaque()) {
-            if (mode == GBlendMode::kSrcOver) {
-                mode = GBlendMode::kSrc;
-            }
-            if (mode == GBlendMode::kDstIn) {
-                mode = GBlendMode::kDst;
-            }
-            if (mode == GBlendMode::kDstOut) {
-                mode = GBlendMode::kClear;
-            }
-            if (mode == GBlendMode::kSrcATop) {
-                mode = GBlendMode::kSrcIn;
-            }
-            if (mode == GBlendMode::kDstATop) {
-                mode = GBlendMode::kDstOver;
-            }
-        }
-        auto modeIdx = static_cast<int>(mode);
+    auto shader = paint.peekShader();
+    if (!shader) {
+        blend_color_row(row_ptr, count, colorToPixel(paint.getColor()), mode);
+        return;
+    }
 
-        for (auto i = 0; i < count; i++) {
-            blendFuncs[modeIdx](pixelsToFill[i], &row_ptr[i]);
-        }
+    //* no need to run the shader per pixel when it only produces one color
+    if (auto color = shader->asConstantColor()) {
+        blend_color_row(row_ptr, count, *color, mode);
+        return;
+    }
+    if (shader->isRowConstant()) {
+        GPixel color;
+        shader->shadeRow(x, y, 1, &color);
+        blend_color_row(row_ptr, count, color, mode);
+        return;
+    }
+
+    if (shader->isOpaque()) {
+        mode = reduce_mode_opaque(mode);
+    }
+
+    //* read straight out of the bitmap when the row maps 1:1 onto its pixels
+    GBitmap bitmap;
+    int dx, dy;
+    if (shader->asAffineBitmap(&bitmap, &dx, &dy) && x + dx >= 0 &&
+        x + dx + count <= bitmap.width() && y + dy >= 0 && y + dy < bitmap.height()) {
+        blend_pixels_row(row_ptr, count, bitmap.getAddr(x + dx, y + dy), mode);
+        return;
+    }
+
+    GPixel pixelsToFill[count];
+    shader->shadeRow(x, y, count, pixelsToFill);
+    blend_pixels_row(row_ptr, count, pixelsToFill, mode);
+}
+
+// Move from dst toward src by coverage / 255.
+inline GPixel lerp_pixel(GPixel dst, GPixel src, unsigned coverage) {
+    auto inv = 255 - coverage;
+    return GPixel_PackARGB(div255(GPixel_GetA(src) * coverage + GPixel_GetA(dst) * inv),
+                           div255(GPixel_GetR(src) * coverage + GPixel_GetR(dst) * inv),
+                           div255(GPixel_GetG(src) * coverage + GPixel_GetG(dst) * inv),
+                           div255(GPixel_GetB(src) * coverage + GPixel_GetB(dst) * inv));
+}
+
+/**
+ *  Blend the paint into [x, y] ... [x + count - 1, y], where each pixel is only partially
+ *  covered by the geometry: result = lerp(dst, blend(src, dst), coverage[i] / 255).
+ */
+inline void blend_anti_row(int x, int y, int count, const uint8_t coverage[], const GPaint& paint,
+                           const GBitmap& fDevice) {
+    if (count <= 0)
+        return;
+
+    auto row_ptr = fDevice.getAddr(x, y);
+    auto mode = paint.getBlendMode();
+    auto modeIdx = static_cast<int>(mode);
+    GPixel src[count];
+    if (auto shader = paint.peekShader()) {
+        shader->shadeRow(x, y, count, src);
     } else {
-        // std::cout << "no shader" << std::endl;
-        auto color = paint.getColor();
-        auto pixelToFill = colorToPixel(color);
-        if (color.a == 1) {
-            switch (mode) {
-            case GBlendMode::kSrcOver:
-                mode = GBlendMode::kSrc;
-                break;
-            case GBlendMode::kDstIn:
-                mode = GBlendMode::kDst;
-                break;
-            case GBlendMode::kDstOut:
-                mode = GBlendMode::kClear;
-                break;
-            case GBlendMode::kSrcATop:
-                mode = GBlendMode::kSrcIn;
-                break;
-            case GBlendMode::kDstATop:
-                mode = GBlendMode::kDstOver;
-                break;
-            default:
-                break;
-            }
+        std::fill(src, src + count, colorToPixel(paint.getColor()));
+    }
 
-        } else if (color.a == 0) {
-            switch (mode) {
-            case GBlendMode::kSrc:
-            case GBlendMode::kSrcIn:
-            case GBlendMode::kDstIn:
-            case GBlendMode::kSrcOut:
-            case GBlendMode::kDstATop:
-                mode = GBlendMode::kClear;
-                break;
-            case GBlendMode::kSrcOver:
-            case GBlendMode::kDstOver:
-            case GBlendMode::kDstOut:
-            case GBlendMode::kSrcATop:
-            case GBlendMode::kXor:
-                mode = GBlendMode::kDst;
-                break;
-            default:
-                break;
-            }
+    for (auto i = 0; i < count;) {
+        auto cov = coverage[i];
+        auto n = 1;
+        while (i + n < count && coverage[i + n] == cov) {
+            n++;
         }
-        auto modeIdx = static_cast<int>(mode);
-        for (auto i = 0; i < count; i++) {
-            blendFuncs[modeIdx](pixelToFill, &row_ptr[i]);
+        if (cov == 255) {
+            blend_pixels_row(row_ptr + i, n, src + i, mode);
+        } else if (cov != 0) {
+            for (auto j = i; j < i + n; j++) {
+                auto blended = row_ptr[j];
+                blendFuncs[modeIdx](src[j], &blended);
+                row_ptr[j] = lerp_pixel(row_ptr[j], blended, cov);
+            }
         }
+        i += n;
     }
 }